@@ -0,0 +1,360 @@
+#include "batchLife.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+enum { TOP, BOTTOM, LEFT, RIGHT };
+
+static inline uint64_t *batchRow(const st_lifeBatch *batch, uint64_t *cells, int y) {
+    return cells + (long long) (y + 1) * batch->stride + 1;
+}
+
+static inline bool emptyBox(const int *box) {
+    return box[TOP] >= box[BOTTOM] || box[LEFT] >= box[RIGHT];
+}
+
+static void unionBox(int *out, const int *a, const int *b) {
+    if (emptyBox(a) || emptyBox(b)) {
+        memcpy(out, emptyBox(a) ? b : a, 4 * sizeof(int));
+        return;
+    }
+    out[TOP] = std::min(a[TOP], b[TOP]);
+    out[BOTTOM] = std::max(a[BOTTOM], b[BOTTOM]);
+    out[LEFT] = std::min(a[LEFT], b[LEFT]);
+    out[RIGHT] = std::max(a[RIGHT], b[RIGHT]);
+}
+
+static void clearBox(const st_lifeBatch *batch, uint64_t *cells, const int *box) {
+    if (emptyBox(box)) {
+        return;
+    }
+    for (int y = box[TOP]; y < box[BOTTOM]; ++y) {
+        memset(batchRow(batch, cells, y) + box[LEFT], 0, (size_t) (box[RIGHT] - box[LEFT]) * sizeof(uint64_t));
+    }
+}
+
+int createLifeBatch(st_lifeBatch *batch, int width, int height, const st_rule *rule, int margin, int maxPeriod,
+                    int maxGenerations) {
+    *batch = {};
+    if (rule->states != 2 || rule->isotropic) {
+        std::cout << "ERROR::BATCH_LIFE::UNSUPPORTED_RULE" << std::endl;
+        return 0;
+    }
+    batch->width = width;
+    batch->height = height;
+    batch->stride = width + 2;
+    batch->margin = margin;
+    batch->maxPeriod = maxPeriod;
+    batch->maxGenerations = maxGenerations;
+    compileRule(&batch->circuit, rule);
+
+    // the sum planes, the term being built and the columns holding live cells of the row loop
+    const size_t words = (size_t) batch->stride * (height + 2);
+    batch->cells[0] = (uint64_t *) calloc(words, sizeof(uint64_t));
+    batch->cells[1] = (uint64_t *) calloc(words, sizeof(uint64_t));
+    batch->snapshot = (uint64_t *) calloc(words, sizeof(uint64_t));
+    batch->sums = (uint64_t *) calloc((size_t) (batch->circuit.sumBits + 2) * width, sizeof(uint64_t));
+    if (!batch->cells[0] || !batch->cells[1] || !batch->snapshot || !batch->sums) {
+        std::cout << "ERROR::BATCH_LIFE::ALLOCATION_FAILED" << std::endl;
+        destroyLifeBatch(batch);
+        return 0;
+    }
+    return 1;
+}
+
+void destroyLifeBatch(st_lifeBatch *batch) {
+    free(batch->cells[0]);
+    free(batch->cells[1]);
+    free(batch->snapshot);
+    free(batch->sums);
+    batch->cells[0] = batch->cells[1] = batch->snapshot = batch->sums = nullptr;
+}
+
+void startBatchLane(st_lifeBatch *batch, int lane, long long id) {
+    batch->lanes[lane] = {id, 0, 0, false};
+    batch->active |= 1ull << lane;
+}
+
+static void clearLaneCells(st_lifeBatch *batch, uint64_t keep) {
+    const int *box = batch->box[batch->current];
+    for (int y = box[TOP]; y < box[BOTTOM]; ++y) {
+        uint64_t *row = batchRow(batch, batch->cells[batch->current], y);
+        for (int x = box[LEFT]; x < box[RIGHT]; ++x) {
+            row[x] &= keep;
+        }
+    }
+}
+
+void clearBatchLane(st_lifeBatch *batch, int lane) {
+    const uint64_t keep = ~(1ull << lane);
+    clearLaneCells(batch, keep);
+    batch->active &= keep;
+    batch->tracked &= keep;
+}
+
+void setBatchCell(st_lifeBatch *batch, int lane, int x, int y, int alive) {
+    uint64_t *word = batchRow(batch, batch->cells[batch->current], y) + x;
+    *word = alive ? *word | 1ull << lane : *word & ~(1ull << lane);
+    if (alive) {
+        int *box = batch->box[batch->current];
+        const int cell[4] = {y, y + 1, x, x + 1};
+        unionBox(box, box, cell);
+    }
+}
+
+int getBatchCell(const st_lifeBatch *batch, int lane, int x, int y) {
+    return (int) (batchRow(batch, batch->cells[batch->current], y)[x] >> lane) & 1;
+}
+
+void exportBatchLane(const st_lifeBatch *batch, int lane, st_lifeBoard *board) {
+    memset(board->cells, 0, (size_t) board->planes * (board->height + 2) * board->wordsPerRow * sizeof(uint64_t));
+    const int *box = batch->box[batch->current];
+    for (int y = box[TOP]; y < box[BOTTOM]; ++y) {
+        const uint64_t *row = batchRow(batch, batch->cells[batch->current], y);
+        uint64_t *out = lifeRow(board, y);
+        for (int x = box[LEFT]; x < box[RIGHT]; ++x) {
+            out[x >> 6] |= ((row[x] >> lane) & 1) << (x & 63);
+        }
+    }
+}
+
+void importBatchLane(st_lifeBatch *batch, int lane, const st_lifeBoard *board) {
+    clearLaneCells(batch, ~(1ull << lane));
+    for (int y = 0; y < board->height; ++y) {
+        const uint64_t *row = lifeRow(board, y);
+        for (int x = 0; x < board->wordsPerRow; ++x) {
+            for (uint64_t bits = row[x]; bits; bits &= bits - 1) {
+                setBatchCell(batch, lane, 64 * x + __builtin_ctzll(bits), y, 1);
+            }
+        }
+    }
+    batch->tracked &= ~(1ull << lane);
+}
+
+static inline void fullAdd(uint64_t *sum, uint64_t *carry, uint64_t a, uint64_t b, uint64_t c) {
+    *sum = a ^ b ^ c;
+    *carry = (a & b) | (c & (a ^ b));
+}
+
+// Moore rows run this many words through the adder and the terms at a time, on the stack where nothing else can alias
+// them, so that both loops vectorize
+static const int BATCH_CHUNK = 32;
+
+static void stepMooreRow(const st_ruleCircuit *circuit, uint64_t *out, const uint64_t *above, const uint64_t *middle,
+                         const uint64_t *below, int left, int right) {
+    uint64_t sum[4][BATCH_CHUNK], result[BATCH_CHUNK];
+    for (int first = left; first < right; first += BATCH_CHUNK) {
+        const int count = std::min(BATCH_CHUNK, right - first);
+        const uint64_t *a = above + first, *m = middle + first, *b = below + first;
+        for (int i = 0; i < count; ++i) {
+            uint64_t u0, u1, l0, l1, c0, x0, x1;
+            fullAdd(&u0, &u1, a[i - 1], a[i], a[i + 1]);
+            fullAdd(&l0, &l1, b[i - 1], b[i], b[i + 1]);
+            const uint64_t m0 = m[i - 1] ^ m[i + 1], m1 = m[i - 1] & m[i + 1];
+            fullAdd(&sum[0][i], &c0, u0, l0, m0);
+            fullAdd(&x0, &x1, u1, l1, m1);
+            sum[1][i] = x0 ^ c0;
+            const uint64_t y1 = x0 & c0;
+            sum[2][i] = x1 ^ y1;
+            sum[3][i] = x1 & y1;
+            result[i] = 0;
+        }
+        // each term in one pass
+        for (int t = 0; t < circuit->termCount; ++t) {
+            const int n = circuit->terms[t].count, when = circuit->terms[t].when;
+            const uint64_t flip0 = n & 1 ? 0 : ~0ull, flip1 = n & 2 ? 0 : ~0ull, flip2 = n & 4 ? 0 : ~0ull;
+            const uint64_t flip3 = n & 8 ? 0 : ~0ull;
+            const uint64_t dead = when & st_ruleCircuit::DEAD ? ~0ull : 0;
+            const uint64_t alive = when & st_ruleCircuit::ALIVE ? ~0ull : 0;
+            for (int i = 0; i < count; ++i) {
+                result[i] |= (sum[0][i] ^ flip0) & (sum[1][i] ^ flip1) & (sum[2][i] ^ flip2) & (sum[3][i] ^ flip3) &
+                             ((m[i] & alive) | (~m[i] & dead));
+            }
+        }
+        std::copy(result, result + count, out + first);
+    }
+}
+
+// Cells [left, right) of one row, every loop runs along the row so that it vectorizes
+static void stepBatchRow(const st_lifeBatch *batch, uint64_t *out, const uint64_t *above, const uint64_t *middle,
+                         const uint64_t *below, int left, int right) {
+    const st_ruleCircuit *circuit = &batch->circuit;
+    if (circuit->neighborhood == NEIGHBORHOOD_MOORE) {
+        stepMooreRow(circuit, out, above, middle, below, left, right);
+        return;
+    }
+    const int sumBits = circuit->sumBits, width = batch->width;
+    uint64_t *sum = batch->sums, *term = batch->sums + (size_t) sumBits * width;
+
+    // the other neighborhoods are Moore with zero weights
+    const uint64_t *neighbors[8] = {above - 1, above, above + 1, middle - 1, middle + 1, below - 1, below, below + 1};
+    for (int j = 0; j < sumBits; ++j) {
+        std::fill(sum + (size_t) j * width + left, sum + (size_t) j * width + right, 0);
+    }
+    for (int k = 0; k < 8; ++k) {
+        for (int bit = 0; circuit->weights[k] >> bit; ++bit) {
+            if (!((circuit->weights[k] >> bit) & 1)) {
+                continue;
+            }
+            for (int x = left; x < right; ++x) {
+                uint64_t carry = neighbors[k][x];
+                for (int j = bit; j < sumBits; ++j) {
+                    uint64_t next = sum[(size_t) j * width + x] & carry;
+                    sum[(size_t) j * width + x] ^= carry;
+                    carry = next;
+                }
+            }
+        }
+    }
+
+    std::fill(out + left, out + right, 0);
+    for (int i = 0; i < circuit->termCount; ++i) {
+        const int when = circuit->terms[i].when, count = circuit->terms[i].count;
+        for (int x = left; x < right; ++x) {
+            term[x] = when == st_ruleCircuit::DEAD ? ~middle[x] : when == st_ruleCircuit::ALIVE ? middle[x] : ~0ull;
+        }
+        for (int j = 0; j < sumBits; ++j) {
+            const uint64_t flip = (count >> j) & 1 ? 0 : ~0ull, *plane = sum + (size_t) j * width;
+            for (int x = left; x < right; ++x) {
+                term[x] &= plane[x] ^ flip;
+            }
+        }
+        for (int x = left; x < right; ++x) {
+            out[x] |= term[x];
+        }
+    }
+}
+
+// Lanes with live cells within margin of the edge
+static uint64_t escapedLanes(const st_lifeBatch *batch, const int *box) {
+    const int margin = batch->margin, width = batch->width, height = batch->height;
+    if (!margin || emptyBox(box) || (box[TOP] >= margin && box[BOTTOM] <= height - margin &&
+                                     box[LEFT] >= margin && box[RIGHT] <= width - margin)) {
+        return 0;
+    }
+    uint64_t lanes = 0;
+    for (int y = box[TOP]; y < box[BOTTOM]; ++y) {
+        const uint64_t *row = batchRow(batch, batch->cells[batch->current], y);
+        const bool band = y < margin || y >= height - margin;
+        const int left = band ? box[RIGHT] : std::min(box[RIGHT], margin);
+        for (int x = box[LEFT]; x < left; ++x) {
+            lanes |= row[x];
+        }
+        for (int x = band ? box[LEFT] : std::max(box[LEFT], width - margin); x < box[RIGHT]; ++x) {
+            lanes |= row[x];
+        }
+    }
+    return lanes;
+}
+
+// Lanes that differ from the snapshot
+static uint64_t changedLanes(const st_lifeBatch *batch) {
+    int box[4];
+    unionBox(box, batch->box[batch->current], batch->snapshotBox);
+    if (emptyBox(box)) {
+        return 0;
+    }
+    uint64_t lanes = 0;
+    for (int y = box[TOP]; y < box[BOTTOM]; ++y) {
+        const uint64_t *row = batchRow(batch, batch->cells[batch->current], y);
+        const uint64_t *snapshot = batchRow(batch, batch->snapshot, y);
+        for (int x = box[LEFT]; x < box[RIGHT]; ++x) {
+            lanes |= row[x] ^ snapshot[x];
+        }
+    }
+    return lanes;
+}
+
+uint64_t stepLifeBatch(st_lifeBatch *batch) {
+    const int c = batch->current, n = 1 - c, width = batch->width;
+    const int *box = batch->box[c];
+
+    // whatever the other buffer held two generations ago, then the live cells and the ones next to them
+    clearBox(batch, batch->cells[n], batch->box[n]);
+    int next[4] = {0, 0, 0, 0};
+    if (!emptyBox(box)) {
+        const int top = std::max(box[TOP] - 1, 0), bottom = std::min(box[BOTTOM] + 1, batch->height);
+        const int left = std::max(box[LEFT] - 1, 0), right = std::min(box[RIGHT] + 1, width);
+        uint64_t *columns = batch->sums + (size_t) (batch->circuit.sumBits + 1) * width;
+        std::fill(columns + left, columns + right, 0);
+        next[TOP] = bottom;
+        for (int y = top; y < bottom; ++y) {
+            uint64_t *out = batchRow(batch, batch->cells[n], y);
+            stepBatchRow(batch, out, batchRow(batch, batch->cells[c], y - 1), batchRow(batch, batch->cells[c], y),
+                         batchRow(batch, batch->cells[c], y + 1), left, right);
+            uint64_t any = 0;
+            for (int x = left; x < right; ++x) {
+                any |= out[x];
+                columns[x] |= out[x];
+            }
+            if (any) {
+                next[TOP] = std::min(next[TOP], y);
+                next[BOTTOM] = y + 1;
+            }
+        }
+        for (next[LEFT] = left; next[LEFT] < right && !columns[next[LEFT]]; ++next[LEFT]) {}
+        for (next[RIGHT] = right; next[RIGHT] > next[LEFT] && !columns[next[RIGHT] - 1]; --next[RIGHT]) {}
+    }
+    memcpy(batch->box[n], next, sizeof(next));
+    batch->current = n;
+    ++batch->generation;
+
+    // a board that repeats the snapshot has settled, every state determines all that follow
+    const long long since = batch->generation % batch->maxPeriod ? batch->generation % batch->maxPeriod
+                                                                   : batch->maxPeriod;
+    uint64_t settled = batch->tracked ? batch->tracked & ~changedLanes(batch) : 0;
+    uint64_t escaped = escapedLanes(batch, next) & batch->active & ~settled;
+    uint64_t finished = settled | escaped;
+    for (uint64_t lanes = batch->active; lanes; lanes &= lanes - 1) {
+        st_batchLane *lane = &batch->lanes[__builtin_ctzll(lanes)];
+        if (++lane->generation >= batch->maxGenerations) {
+            finished |= 1ull << __builtin_ctzll(lanes);
+        }
+    }
+    for (uint64_t lanes = settled; lanes; lanes &= lanes - 1) {
+        batch->lanes[__builtin_ctzll(lanes)].period = (int) since;
+    }
+    for (uint64_t lanes = escaped; lanes; lanes &= lanes - 1) {
+        batch->lanes[__builtin_ctzll(lanes)].escaped = true;
+    }
+
+    if (batch->generation % batch->maxPeriod == 0) {
+        clearBox(batch, batch->snapshot, batch->snapshotBox);
+        for (int y = next[TOP]; y < next[BOTTOM] && !emptyBox(next); ++y) {
+            memcpy(batchRow(batch, batch->snapshot, y) + next[LEFT], batchRow(batch, batch->cells[n], y) + next[LEFT],
+                   (size_t) (next[RIGHT] - next[LEFT]) * sizeof(uint64_t));
+        }
+        memcpy(batch->snapshotBox, next, sizeof(next));
+        batch->tracked = batch->active & ~finished;
+    }
+    return finished;
+}
+
+void runLifeBatch(st_lifeBatch *batch, const std::function<bool(int)> &fill, const std::function<bool(int)> &finish) {
+    bool more = true;
+    for (int lane = 0; lane < BATCH_LANES && more; ++lane) {
+        if (!((batch->active >> lane) & 1)) {
+            more = fill(lane);
+        }
+    }
+    while (batch->active) {
+        uint64_t finished = stepLifeBatch(batch);
+        // a few long runs alone would keep stepping the whole box
+        if (!more && __builtin_popcountll(batch->active) < BATCH_MIN_LANES) {
+            finished = batch->active;
+        }
+        for (; finished; finished &= finished - 1) {
+            int lane = __builtin_ctzll(finished);
+            if (!finish(lane)) {
+                batch->lanes[lane].escaped = false;
+                continue;
+            }
+            clearBatchLane(batch, lane);
+            if (more) {
+                more = fill(lane);
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef CONWAY_LIFE_BATCH_LIFE_H
+#define CONWAY_LIFE_BATCH_LIFE_H
+
+#include "rule.h"
+#include "cpuLife.h"
+
+#include <cstdint>
+#include <functional>
+
+// Bit-sliced batch of BATCH_LANES small boards of the same size and rule. Word (x, y) holds cell (x, y) of every
+// board, bit b for the board in lane b, so one word operation steps every board at once and the row loops vectorize
+// across words however small the boards are. Rows and columns outside the boards are dead padding.
+// Boards are compared against a snapshot of the batch taken every maxPeriod generations; a board that matches it has
+// settled with the period since. Settled boards, boards with live cells within margin of the edge and boards at
+// maxGenerations are handed back so that their lanes can be refilled.
+const int BATCH_LANES = 64;
+const int BATCH_MIN_LANES = 16;  // runLifeBatch hands back every board once there are fewer left and no more to start
+
+struct st_batchLane {
+    long long id;
+    int generation;
+    int period;  // 0 until settled
+    bool escaped;  // reached the margin
+};
+
+struct st_lifeBatch {
+    int width;
+    int height;
+    int stride;  // words per row, width + 2
+    int margin;  // 0 never hands boards back for reaching the edge
+    int maxPeriod;
+    int maxGenerations;
+    st_ruleCircuit circuit;
+    uint64_t *cells[2];
+    uint64_t *snapshot;
+    uint64_t *sums;  // one row per sum plane
+    int current;
+    int box[2][4];  // top, bottom, left, right of the cells each buffer may hold, bottom and right exclusive
+    int snapshotBox[4];
+    long long generation;
+    uint64_t active;  // lanes holding a board
+    uint64_t tracked;  // lanes the snapshot was taken of
+    st_batchLane lanes[BATCH_LANES];
+};
+
+// Two-state rules without isotropic conditions, on any neighborhood
+int createLifeBatch(st_lifeBatch *batch, int width, int height, const st_rule *rule, int margin, int maxPeriod,
+                    int maxGenerations);
+
+void destroyLifeBatch(st_lifeBatch *batch);
+
+// Puts board id in an empty lane, all dead until cells are set
+void startBatchLane(st_lifeBatch *batch, int lane, long long id);
+
+// Clears the lane and marks it empty
+void clearBatchLane(st_lifeBatch *batch, int lane);
+
+void setBatchCell(st_lifeBatch *batch, int lane, int x, int y, int alive);
+
+int getBatchCell(const st_lifeBatch *batch, int lane, int x, int y);
+
+// Copies the live cells of the lane into board, which must be the size of the batch and is cleared first
+void exportBatchLane(const st_lifeBatch *batch, int lane, st_lifeBoard *board);
+
+// Replaces the cells of the lane with the live cells of board, the lane waits for the next snapshot to settle
+void importBatchLane(st_lifeBatch *batch, int lane, const st_lifeBoard *board);
+
+// Advances every board by one generation, returns the lanes that finished
+uint64_t stepLifeBatch(st_lifeBatch *batch);
+
+// Fills every empty lane with fill(lane), which starts a board or returns false when there are no more, and steps
+// until every board has finished, or until fewer than BATCH_MIN_LANES are left with no more to start, which are then
+// handed back as they are. finish(lane) is called for each and returns true to have the lane cleared and refilled, or
+// false to keep stepping it, e.g. after taking escaping objects off the board.
+void runLifeBatch(st_lifeBatch *batch, const std::function<bool(int)> &fill, const std::function<bool(int)> &finish);
+
+#endif
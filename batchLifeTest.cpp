@@ -0,0 +1,102 @@
+#include "batchLife.h"
+#include "cpuLife.h"
+#include "soup.h"
+#include "soupSearch.h"
+#include "testReport.h"
+
+#include <iostream>
+#include <vector>
+#include <utility>
+
+// Steps a full batch of soups next to the same soups on the single-board engine and compares every lane with its
+// board after every generation, then runs the soup search with and without the batch and compares the censuses.
+// The exit code tells whether everything matched.
+
+const int WIDTH = 96;
+const int HEIGHT = 80;
+const int GENERATIONS = 200;
+const long long SOUPS = 512;
+
+// mismatched cells over every lane and generation
+static long long crossCheck(const char *ruleString) {
+    st_rule rule;
+    st_ruleCircuit circuit;
+    st_lifeBatch batch;
+    if (!parseRule(&rule, ruleString) || !createLifeBatch(&batch, WIDTH, HEIGHT, &rule, 0, 64, GENERATIONS + 1)) {
+        return -1;
+    }
+    compileRule(&circuit, &rule);
+    std::vector<st_lifeBoard> boards(2 * BATCH_LANES);
+    for (int lane = 0; lane < BATCH_LANES; ++lane) {
+        createLifeBoard(&boards[2 * lane], WIDTH, HEIGHT, 2);
+        createLifeBoard(&boards[2 * lane + 1], WIDTH, HEIGHT, 2);
+        startBatchLane(&batch, lane, lane);
+        // soups of different sizes and densities, some of them against the edge
+        const int size = 8 + lane % 5 * 8, left = lane * 7 % (WIDTH - size), top = lane * 13 % (HEIGHT - size);
+        for (int y = 0; y < size; ++y) {
+            uint64_t cells = soupWord(lane, soupThreshold(.25 + lane % 3 * .15), 0, y);
+            for (int x = 0; x < size; ++x) {
+                if ((cells >> x) & 1) {
+                    setBatchCell(&batch, lane, left + x, top + y, 1);
+                    setCell(&boards[2 * lane], left + x, top + y, 1);
+                }
+            }
+        }
+    }
+
+    st_lifeBoard exported;
+    createLifeBoard(&exported, WIDTH, HEIGHT, 2);
+    long long mismatches = 0;
+    for (int generation = 0; generation < GENERATIONS; ++generation) {
+        stepLifeBatch(&batch);
+        for (int lane = 0; lane < BATCH_LANES; ++lane) {
+            stepLife(&boards[2 * lane + 1], &boards[2 * lane], &circuit, 1, nullptr);
+            std::swap(boards[2 * lane], boards[2 * lane + 1]);
+            exportBatchLane(&batch, lane, &exported);
+            for (int y = 0; y < HEIGHT; ++y) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    mismatches += getCell(&exported, x, y) != getCell(&boards[2 * lane], x, y);
+                }
+            }
+        }
+    }
+    destroyLifeBoard(&exported);
+    for (st_lifeBoard &board : boards) {
+        destroyLifeBoard(&board);
+    }
+    destroyLifeBatch(&batch);
+    return mismatches;
+}
+
+static bool sameCensus(const st_census *a, const st_census *b) {
+    if (a->soups != b->soups || a->unsettled != b->unsettled || a->objects.size() != b->objects.size()) {
+        return false;
+    }
+    for (const auto &[apgcode, entry] : a->objects) {
+        auto other = b->objects.find(apgcode);
+        if (other == b->objects.end() || other->second.count != entry.count || other->second.sample != entry.sample) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    int failures = crossCheckRules(crossCheck);
+
+    st_soupSearch search;
+    if (!createSoupSearch(&search, "B3/S23", 1)) {
+        return -1;
+    }
+    st_census batched = {}, single = {};
+    searchSoups(&search, 0, SOUPS, &batched);
+    search.batched = false;
+    searchSoups(&search, 0, SOUPS, &single);
+    destroySoupSearch(&search);
+    const bool same = sameCensus(&batched, &single);
+    std::cout << "Census of " << SOUPS << " soups with and without the batch: " << (same ? "same" : "different")
+              << std::endl;
+    failures += !same;
+
+    return reportTest("Batch", failures);
+}
@@ -0,0 +1,95 @@
+#include "boardMemory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <cstdio>
+#include <cstring>
+#endif
+
+#if defined(__linux__)
+
+static inline size_t hugeSize(size_t size) {
+    return (size + BOARD_HUGE_PAGE - 1) / BOARD_HUGE_PAGE * BOARD_HUGE_PAGE;
+}
+
+void *allocateBoard(size_t size) {
+    if (size < BOARD_HUGE_PAGE) {
+        return calloc(size, 1);
+    }
+    const size_t length = hugeSize(size);
+    // explicit huge pages only exist when reserved through vm.nr_hugepages, and mapping fails when too few are free
+    void *data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+        return data;
+    }
+
+    // one huge page more than needed, trimmed to the aligned part
+    char *mapping = (char *) mmap(nullptr, length + BOARD_HUGE_PAGE, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    char *aligned = (char *) (((uintptr_t) mapping + BOARD_HUGE_PAGE - 1) / BOARD_HUGE_PAGE * BOARD_HUGE_PAGE);
+    const size_t head = aligned - mapping, tail = BOARD_HUGE_PAGE - head;
+    if (head) {
+        munmap(mapping, head);
+    }
+    if (tail) {
+        munmap(aligned + length, tail);
+    }
+    madvise(aligned, length, MADV_HUGEPAGE);
+    return aligned;
+}
+
+void freeBoard(void *data, size_t size) {
+    if (size < BOARD_HUGE_PAGE) {
+        free(data);
+    } else if (data) {
+        munmap(data, hugeSize(size));
+    }
+}
+
+size_t hugePageBytes(const void *data, size_t size) {
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) {
+        return 0;
+    }
+    // the huge page counts of every mapping overlapping the range, which may reach past it
+    const uintptr_t begin = (uintptr_t) data, end = begin + size;
+    bool overlaps = false;
+    size_t bytes = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), smaps)) {
+        unsigned long long first, last, kilobytes;
+        char field[64];
+        if (sscanf(line, "%llx-%llx ", &first, &last) == 2) {
+            overlaps = first < end && last > begin;
+        } else if (overlaps && sscanf(line, "%63[^:]: %llu kB", field, &kilobytes) == 2 &&
+                   (!strcmp(field, "AnonHugePages") || !strcmp(field, "Private_Hugetlb") ||
+                    !strcmp(field, "Shared_Hugetlb"))) {
+            bytes += kilobytes << 10;
+        }
+    }
+    fclose(smaps);
+    return std::min(bytes, size);
+}
+
+#else
+
+void *allocateBoard(size_t size) {
+    return calloc(size, 1);
+}
+
+void freeBoard(void *data, size_t) {
+    free(data);
+}
+
+size_t hugePageBytes(const void *, size_t) {
+    return 0;
+}
+
+#endif
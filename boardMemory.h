@@ -0,0 +1,21 @@
+#ifndef CONWAY_LIFE_BOARD_MEMORY_H
+#define CONWAY_LIFE_BOARD_MEMORY_H
+
+#include <cstddef>
+
+// Zeroed memory for the CPU board buffers. On Linux, buffers of at least BOARD_HUGE_PAGE bytes are mapped on huge
+// page boundaries, from the hugetlbfs pool when it has pages to spare and as transparent huge pages (MADV_HUGEPAGE)
+// otherwise, so that sweeping a large board does not take a TLB miss every few rows. Smaller buffers and other
+// platforms use calloc. Pages are placed on a NUMA node when first touched.
+const size_t BOARD_HUGE_PAGE = 2 << 20;
+
+// Returns null when out of memory
+void *allocateBoard(size_t size);
+
+// size as passed to allocateBoard
+void freeBoard(void *data, size_t size);
+
+// Bytes of [data, data + size) backed by huge pages so far, 0 where the platform cannot tell
+size_t hugePageBytes(const void *data, size_t size);
+
+#endif
@@ -0,0 +1,126 @@
+#include "census.h"
+#include "mapping.h"
+
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+
+static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// 'y' takes runs of 4 to 39 columns, one digit of the 36 for the run less 4
+static void encodeZeros(std::string *out, int run) {
+    for (; run >= 4; run -= std::min(run, 39)) {
+        *out += 'y';
+        *out += DIGITS[std::min(run, 39) - 4];
+    }
+    *out += run == 3 ? "x" : run == 2 ? "w" : run == 1 ? "0" : "";
+}
+
+// code of the cells in one orientation, 0 .. 7: bit 2 swaps x and y, bit 0 mirrors x, bit 1 mirrors y
+static std::string encode(const std::vector<st_cell> &cells, int orientation) {
+    if (cells.empty()) {
+        return "";
+    }
+    std::vector<st_cell> oriented(cells.size());
+    int minX = INT32_MAX, minY = INT32_MAX, maxX = INT32_MIN, maxY = INT32_MIN;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        int x = orientation & 4 ? cells[i].y : cells[i].x, y = orientation & 4 ? cells[i].x : cells[i].y;
+        oriented[i] = {orientation & 1 ? -x : x, orientation & 2 ? -y : y};
+        minX = std::min(minX, oriented[i].x);
+        minY = std::min(minY, oriented[i].y);
+        maxX = std::max(maxX, oriented[i].x);
+        maxY = std::max(maxY, oriented[i].y);
+    }
+    const int width = maxX - minX + 1, strips = (maxY - minY) / 5 + 1;
+    std::vector<unsigned char> columns((size_t) width * strips, 0);
+    for (const st_cell &cell : oriented) {
+        int y = cell.y - minY;
+        columns[(size_t) (y / 5) * width + cell.x - minX] |= (unsigned char) (1 << (y % 5));
+    }
+
+    std::string code;
+    for (int strip = 0; strip < strips; ++strip) {
+        if (strip > 0) {
+            code += 'z';
+        }
+        // trailing empty columns are left out
+        int zeros = 0;
+        for (int x = 0; x < width; ++x) {
+            unsigned char column = columns[(size_t) strip * width + x];
+            if (column) {
+                encodeZeros(&code, zeros);
+                zeros = 0;
+                code += DIGITS[column];
+            } else {
+                ++zeros;
+            }
+        }
+    }
+    return code;
+}
+
+std::string wechslerCode(const std::vector<std::vector<st_cell>> &phases) {
+    std::string best;
+    for (const auto &phase : phases) {
+        for (int orientation = 0; orientation < 8; ++orientation) {
+            std::string code = encode(phase, orientation);
+            if (best.empty() || code.size() < best.size() || (code.size() == best.size() && code < best)) {
+                best = code;
+            }
+        }
+    }
+    return best;
+}
+
+void censusAdd(st_census *census, const std::string &apgcode, long long soup) {
+    auto entry = census->objects.find(apgcode);
+    if (entry == census->objects.end()) {
+        census->objects[apgcode] = {1, soup};
+    } else {
+        ++entry->second.count;
+        entry->second.sample = std::min(entry->second.sample, soup);
+    }
+}
+
+void mergeCensus(st_census *into, const st_census *from) {
+    for (const auto &[apgcode, entry] : from->objects) {
+        auto existing = into->objects.find(apgcode);
+        if (existing == into->objects.end()) {
+            into->objects[apgcode] = entry;
+        } else {
+            existing->second.count += entry.count;
+            existing->second.sample = std::min(existing->second.sample, entry.sample);
+        }
+    }
+    into->soups += from->soups;
+    into->unsettled += from->unsettled;
+}
+
+int writeCensus(const char *file, const st_census *census, const char *rule, uint64_t seed) {
+    std::vector<std::pair<std::string, st_censusEntry>> objects(census->objects.begin(), census->objects.end());
+    std::sort(objects.begin(), objects.end(), [](const auto &a, const auto &b) {
+        return a.second.count != b.second.count ? a.second.count > b.second.count : a.first < b.first;
+    });
+
+    // readers never see a half written census
+    std::string temporary = std::string(file) + ".tmp";
+    FILE *f = fopen(temporary.c_str(), "w");
+    if (!f) {
+        std::cout << "ERROR::CENSUS::OPEN_FAILED" << std::endl;
+        std::cout << temporary << std::endl;
+        return 0;
+    }
+    fprintf(f, "# rule %s seed %llu soups %lld unsettled %lld\n", rule, (unsigned long long) seed, census->soups,
+            census->unsettled);
+    for (const auto &[apgcode, entry] : objects) {
+        fprintf(f, "%lld %s %lld\n", entry.count, apgcode.c_str(), entry.sample);
+    }
+    int success = !ferror(f);
+    success = fclose(f) == 0 && success && replaceFile(temporary.c_str(), file);
+    if (!success) {
+        std::cout << "ERROR::CENSUS::WRITE_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        remove(temporary.c_str());
+    }
+    return success;
+}
@@ -0,0 +1,40 @@
+#ifndef CONWAY_LIFE_CENSUS_H
+#define CONWAY_LIFE_CENSUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Tally of the objects left when soups settle, keyed by apgcode as used on Catagolue: "xs<population>_" for still
+// lifes, "xp<period>_" for oscillators or "xq<period>_" for spaceships, then the extended Wechsler code of the object.
+// The code reads the object in strips of 5 rows, one character per column with the top row in the lowest bit, 'w',
+// 'x' and 'y' for runs of empty columns and 'z' between strips. Of all orientations and phases the shortest code
+// wins, then the alphabetically first.
+struct st_censusEntry {
+    long long count;
+    long long sample;  // lowest soup the object was seen in
+};
+
+struct st_census {
+    std::unordered_map<std::string, st_censusEntry> objects;
+    long long soups;
+    long long unsettled;  // soups still running when the generation limit was reached
+};
+
+struct st_cell {
+    int x;
+    int y;
+};
+
+// Smallest code over the 8 orientations of every phase
+std::string wechslerCode(const std::vector<std::vector<st_cell>> &phases);
+
+void censusAdd(st_census *census, const std::string &apgcode, long long soup);
+
+void mergeCensus(st_census *into, const st_census *from);
+
+// Rewrites file with one "count apgcode sample" line per object, most common first
+int writeCensus(const char *file, const st_census *census, const char *rule, uint64_t seed);
+
+#endif
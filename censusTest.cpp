@@ -0,0 +1,105 @@
+#include "soupSearch.h"
+#include "testReport.h"
+
+#include <iostream>
+#include <vector>
+#include <map>
+
+// Names known objects, and arrangements of them, the way the soup search does and compares them with their apgcodes
+// on Catagolue. The exit code tells whether every one matched.
+
+struct st_knownPattern {
+    const char *name;
+    std::vector<const char *> rows;  // 'o' for a live cell
+    std::map<std::string, long long> objects;
+};
+
+static std::vector<st_cell> patternCells(const std::vector<const char *> &rows) {
+    std::vector<st_cell> cells;
+    for (int y = 0; y < (int) rows.size(); ++y) {
+        for (int x = 0; rows[y][x]; ++x) {
+            if (rows[y][x] == 'o') {
+                cells.push_back({x, y});
+            }
+        }
+    }
+    return cells;
+}
+
+int main() {
+    const st_knownPattern patterns[] = {
+            {"block", {"oo", "oo"}, {{"xs4_33", 1}}},
+            {"beehive", {".oo.", "o..o", ".oo."}, {{"xs6_696", 1}}},
+            {"loaf", {".oo.", "o..o", ".o.o", "..o."}, {{"xs7_2596", 1}}},
+            {"boat", {"oo.", "o.o", ".o."}, {{"xs5_253", 1}}},
+            {"ship", {"oo.", "o.o", ".oo"}, {{"xs6_356", 1}}},
+            {"tub", {".o.", "o.o", ".o."}, {{"xs4_252", 1}}},
+            {"pond", {".oo.", "o..o", "o..o", ".oo."}, {{"xs8_6996", 1}}},
+            {"blinker", {"ooo"}, {{"xp2_7", 1}}},
+            {"toad", {".ooo", "ooo."}, {{"xp2_7e", 1}}},
+            {"beacon", {"oo..", "oo..", "..oo", "..oo"}, {{"xp2_318c", 1}}},
+            {"pulsar", {"..ooo...ooo..",
+                        ".............",
+                        "o....o.o....o",
+                        "o....o.o....o",
+                        "o....o.o....o",
+                        "..ooo...ooo..",
+                        ".............",
+                        "..ooo...ooo..",
+                        "o....o.o....o",
+                        "o....o.o....o",
+                        "o....o.o....o",
+                        ".............",
+                        "..ooo...ooo.."}, {{"xp3_co9nas0san9oczgoldlo0oldlogz1047210127401", 1}}},
+            {"pentadecathlon", {"..o....o..", "oo.oooo.oo", "..o....o.."}, {{"xp15_4r4z4r4", 1}}},
+            {"glider", {".o.", "..o", "ooo"}, {{"xq4_153", 1}}},
+            // pseudo-objects are counted as their parts
+            {"traffic light", {"..ooo..",
+                               ".......",
+                               "o.....o",
+                               "o.....o",
+                               "o.....o",
+                               ".......",
+                               "..ooo.."}, {{"xp2_7", 4}}},
+            {"blinker pair", {"ooo.ooo"}, {{"xp2_7", 2}}},
+            {"bi-block", {"oo.oo", "oo.oo"}, {{"xs4_33", 2}}},
+    };
+
+    st_soupSearch search;
+    if (!createSoupSearch(&search, "B3/S23", 0)) {
+        return -1;
+    }
+    int failures = 0;
+    for (const st_knownPattern &pattern : patterns) {
+        st_census census = {};
+        searchPattern(&search, patternCells(pattern.rows), &census);
+        std::map<std::string, long long> objects;
+        for (const auto &[apgcode, entry] : census.objects) {
+            objects[apgcode] = entry.count;
+        }
+        if (objects != pattern.objects) {
+            std::cout << "ERROR::CENSUS_TEST::MISMATCH " << pattern.name << ":";
+            for (const auto &[apgcode, count] : objects) {
+                std::cout << " " << count << " " << apgcode;
+            }
+            std::cout << std::endl;
+            ++failures;
+        }
+    }
+
+    // runs of empty columns: 'y' covers 4 to 39 of them, longer runs continue with the next token
+    const struct {
+        int gap;
+        const char *code;
+    } runs[] = {{35, "1yv1"}, {39, "1yz1"}, {40, "1yz01"}, {44, "1yzy11"}};
+    for (const auto &run : runs) {
+        std::string code = wechslerCode({{{0, 0}, {run.gap + 1, 0}}});
+        if (code != run.code) {
+            std::cout << "ERROR::CENSUS_TEST::RUN " << run.gap << ": " << code << std::endl;
+            ++failures;
+        }
+    }
+    destroySoupSearch(&search);
+
+    return reportTest("Census", failures);
+}
@@ -0,0 +1,82 @@
+#include "checkpoint.h"
+#include "mapping.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static const char MAGIC[8] = {'C', 'O', 'N', 'W', 'A', 'Y', 'C', 'K'};
+
+int writeCheckpoint(const char *file, st_checkpointHeader *header, const unsigned char *cells, size_t size) {
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = CHECKPOINT_VERSION;
+    header->payloadOffset = (sizeof(st_checkpointHeader) + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT *
+                            CHECKPOINT_ALIGNMENT;
+    header->payloadSize = size;
+
+    // a crash while writing leaves the previous checkpoint intact
+    std::string temporary = std::string(file) + ".tmp";
+    FILE *f = fopen(temporary.c_str(), "wb");
+    if (!f) {
+        std::cout << "ERROR::CHECKPOINT::OPEN_FAILED" << std::endl;
+        std::cout << temporary << std::endl;
+        return 0;
+    }
+    static const char zeros[CHECKPOINT_ALIGNMENT] = {};
+    int success = fwrite(header, sizeof(st_checkpointHeader), 1, f) == 1 &&
+                  fwrite(zeros, header->payloadOffset - sizeof(st_checkpointHeader), 1, f) == 1 &&
+                  fwrite(cells, size, 1, f) == 1;
+    success = fclose(f) == 0 && success;
+    success = success && replaceFile(temporary.c_str(), file);
+    if (!success) {
+        std::cout << "ERROR::CHECKPOINT::WRITE_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        remove(temporary.c_str());
+    }
+    return success;
+}
+
+int openCheckpoint(st_checkpoint *checkpoint, const char *file) {
+    checkpoint->mapping = mapFile(file, &checkpoint->mappingSize);
+    checkpoint->cells = nullptr;
+    if (!checkpoint->mapping) {
+        std::cout << "ERROR::CHECKPOINT::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+
+    const st_checkpointHeader *header = (const st_checkpointHeader *) checkpoint->mapping;
+    const char *error = nullptr;
+    if (checkpoint->mappingSize < sizeof(st_checkpointHeader) || std::memcmp(header->magic, MAGIC, sizeof(MAGIC))) {
+        error = "NOT_A_CHECKPOINT";
+    } else if (header->version != CHECKPOINT_VERSION) {
+        error = "UNSUPPORTED_VERSION";
+    } else if (header->payloadOffset > checkpoint->mappingSize ||
+               header->payloadSize > checkpoint->mappingSize - header->payloadOffset ||
+               header->payloadSize < (uint64_t) header->stride * (header->height + 2) ||
+               header->rule[sizeof(header->rule) - 1] != '\0' ||
+               header->pattern[sizeof(header->pattern) - 1] != '\0') {
+        error = "CORRUPT";
+    }
+    if (error) {
+        std::cout << "ERROR::CHECKPOINT::" << error << std::endl;
+        std::cout << file << std::endl;
+        closeCheckpoint(checkpoint);
+        return 0;
+    }
+
+    // the board is imported front to back straight from the mapping
+    adviseMapping(checkpoint->mapping, 0, checkpoint->mappingSize, MAPPING_SEQUENTIAL);
+    checkpoint->header = *header;
+    checkpoint->cells = (const unsigned char *) checkpoint->mapping + header->payloadOffset;
+    return 1;
+}
+
+void closeCheckpoint(st_checkpoint *checkpoint) {
+    if (checkpoint->mapping) {
+        unmapFile(checkpoint->mapping, checkpoint->mappingSize);
+    }
+    checkpoint->mapping = nullptr;
+    checkpoint->cells = nullptr;
+}
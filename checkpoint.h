@@ -0,0 +1,48 @@
+#ifndef CONWAY_LIFE_CHECKPOINT_H
+#define CONWAY_LIFE_CHECKPOINT_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Binary checkpoint of a GPU board: a header, padded to CHECKPOINT_ALIGNMENT, followed by the board buffer exactly
+// as it lives on the GPU (one byte of state per cell, stride bytes per row, padding rows included). A payload with the
+// stride of the engine can therefore be mapped from the file and uploaded as is.
+const uint32_t CHECKPOINT_VERSION = 2;
+const size_t CHECKPOINT_ALIGNMENT = 4096;
+
+enum {
+    TOPOLOGY_FLAT,
+    TOPOLOGY_MOBIUS
+};
+
+struct st_checkpointHeader {
+    char magic[8];  // "CONWAYCK"
+    uint32_t version;
+    uint32_t topology;
+    int32_t width;
+    int32_t height;
+    int32_t stride;
+    int32_t states;
+    int64_t generation;
+    uint64_t payloadOffset;
+    uint64_t payloadSize;
+    char rule[128];
+    char pattern[128];  // file the run started from, empty for a random soup
+};
+
+// Mapped checkpoint file, cells points at the payload
+struct st_checkpoint {
+    st_checkpointHeader header;
+    const unsigned char *cells;
+    void *mapping;
+    size_t mappingSize;
+};
+
+// Fills in magic, version and payload fields, writes to a temporary file and renames it over file.
+int writeCheckpoint(const char *file, st_checkpointHeader *header, const unsigned char *cells, size_t size);
+
+int openCheckpoint(st_checkpoint *checkpoint, const char *file);
+
+void closeCheckpoint(st_checkpoint *checkpoint);
+
+#endif
@@ -0,0 +1,317 @@
+#include "conway.h"
+#include "shader.h"
+#include "soup.h"
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+static st_shaderInfo engineShaders[] = {{GL_COMPUTE_SHADER, "lifeCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "isotropicCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "ltlRowSumCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "ltlCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "lifeCompute.glsl", "#define NEIGHBORHOOD_HEXAGONAL\n"},
+                                        {GL_COMPUTE_SHADER, "lifeCompute.glsl", "#define NEIGHBORHOOD_VON_NEUMANN\n"},
+                                        {GL_COMPUTE_SHADER, "lifeCompute.glsl", "#define NEIGHBORHOOD_WEIGHTED\n"},
+                                        {GL_COMPUTE_SHADER, "mobiusEdgesCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "seedCompute.glsl"},
+                                        {GL_COMPUTE_SHADER, "statsCompute.glsl"}};
+
+// life kernel for each neighborhood
+static const int LIFE_SHADERS[] = {0, 4, 5, 6};
+
+// the least GL_MAX_COMPUTE_WORK_GROUP_COUNT any implementation has, kernels loop over rows past it
+static const int MAX_WORK_GROUPS = 65535;
+
+static unsigned int workGroups(int count) {
+    return (unsigned int) std::min(count, MAX_WORK_GROUPS);
+}
+
+int conwayCreate(st_conway *engine, int width, int height, int topology, const char *rule) {
+    *engine = {};
+    engine->width = width;
+    engine->height = height;
+    engine->stride = (width + 2 + 3) / 4 * 4;
+    engine->boardSize = (size_t) engine->stride * (height + 2);
+    engine->topology = topology;
+    engine->ltl = rule[0] == 'R';
+    if (engine->ltl ? !parseLtlRule(&engine->ltlRule, rule) : !parseRule(&engine->rule, rule)) {
+        return 0;
+    }
+    if (engine->ltl) {
+        engine->rule.states = engine->ltlRule.states;
+    }
+    if (engine->ltl && topology == TOPOLOGY_MOBIUS) {
+        // the twisted edges are one cell wide, Larger than Life reads range cells past them
+        std::cout << "ERROR::CONWAY::TOPOLOGY_UNSUPPORTED" << std::endl;
+        return 0;
+    }
+    engine->ltl ? formatLtlRule(engine->ruleName, sizeof(engine->ruleName), &engine->ltlRule)
+                : formatRule(engine->ruleName, sizeof(engine->ruleName), &engine->rule);
+
+    // every life kernel is linked with the statistics it calls
+    const int life = engine->ltl ? 3 : engine->rule.isotropic ? 1 : LIFE_SHADERS[engine->rule.neighborhood];
+    st_shaderInfo lifeShaders[] = {engineShaders[life], engineShaders[9]};
+    if (!createAndLinkProgram(&engine->lifeProgram, lifeShaders, 2) ||
+        !createAndLinkProgram(&engine->seedProgram, engineShaders + 8, 1) ||
+        (engine->ltl && !createAndLinkProgram(&engine->rowSumProgram, engineShaders + 2, 1)) ||
+        (topology == TOPOLOGY_MOBIUS && !createAndLinkProgram(&engine->edgesProgram, engineShaders + 7, 1))) {
+        conwayDestroy(engine);
+        return 0;
+    }
+
+    const int stride = engine->stride;
+    int params[14 + 16 + 6 + 8] = {
+            width,
+            height,
+            // neighborIndices:
+            -stride - 1,  // BOTTOM LEFT
+            -stride,  // BOTTOM
+            -stride + 1,  // BOTTOM RIGHT
+            -1,  // LEFT
+            // SKIP CENTER
+            +1,  // RIGHT
+            +stride - 1,  // UPPER LEFT
+            +stride,  // UP
+            +stride + 1,  // UPPER RIGHT
+            (int) engine->rule.birth,
+            (int) engine->rule.survive,
+            engine->rule.states,
+            stride
+    };
+    for (int i = 0; i < 16; ++i) {
+        params[14 + i] = (int) engine->rule.table[i];
+    }
+    const st_ltlRule &ltlRule = engine->ltlRule;
+    const int ltlParams[] = {ltlRule.range, ltlRule.middle, ltlRule.birthMin, ltlRule.birthMax,
+                             ltlRule.surviveMin, ltlRule.surviveMax};
+    for (int i = 0; i < 6; ++i) {
+        params[30 + i] = ltlParams[i];
+    }
+    for (int i = 0; i < 8; ++i) {
+        params[36 + i] = engine->rule.weights[i];
+    }
+    glGenBuffers(1, &engine->params);
+    glGenBuffers(1, &engine->board);
+    glGenBuffers(1, &engine->previous);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, engine->params);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->params);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(params), params, GL_DYNAMIC_COPY);
+
+    // both boards start dead, padding included
+    std::vector<unsigned char> empty(engine->boardSize, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, engine->board);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, engine->boardSize, empty.data(), GL_STATIC_COPY);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, engine->previous);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->previous);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, engine->boardSize, empty.data(), GL_STATIC_COPY);
+    glGenBuffers(1, &engine->hashes);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, engine->hashes);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->hashes);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, CONWAY_HASHES_SIZE, nullptr, GL_DYNAMIC_COPY);
+    glGenBuffers(1, &engine->stats);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, engine->stats);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->stats);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, CONWAY_STATS_SIZE, nullptr, GL_DYNAMIC_COPY);
+    engine->hashedFrom = 1;
+    if (engine->ltl) {
+        glGenBuffers(1, &engine->rowSums);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, engine->rowSums);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->rowSums);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (size_t) width * height * sizeof(unsigned int), nullptr,
+                     GL_DYNAMIC_COPY);
+    }
+    return 1;
+}
+
+void conwayDestroy(st_conway *engine) {
+    glDeleteProgram(engine->lifeProgram);
+    glDeleteProgram(engine->rowSumProgram);
+    glDeleteProgram(engine->edgesProgram);
+    glDeleteProgram(engine->seedProgram);
+    glDeleteBuffers(1, &engine->params);
+    glDeleteBuffers(1, &engine->board);
+    glDeleteBuffers(1, &engine->previous);
+    glDeleteBuffers(1, &engine->rowSums);
+    glDeleteBuffers(1, &engine->hashes);
+    glDeleteBuffers(1, &engine->stats);
+    *engine = {};
+}
+
+void conwaySeed(st_conway *engine, uint64_t seed, double density) {
+    // generated in place, nothing crosses the bus
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(engine->seedProgram);
+    glUniform2ui(0, (unsigned int) seed, (unsigned int) (seed >> 32));
+    glUniform1ui(1, soupThreshold(density));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, engine->board);
+    glDispatchCompute((engine->width + 63) / 64, workGroups(engine->height), 1);
+    glMemoryBarrier(GL_ALL_BARRIER_BITS);
+    engine->generation = 0;
+    engine->hashedFrom = 1;
+    ++engine->replacements;
+}
+
+void conwayStep(st_conway *engine, int generations) {
+    for (int i = 0; i < generations; ++i) {
+        unsigned int temp = engine->board;
+        engine->board = engine->previous;
+        engine->previous = temp;
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, engine->board);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, engine->previous);
+
+        // the slots of the generation being written, summed into by the life kernel
+        const int slot = (int) ((engine->generation + 1) % CONWAY_HASH_RING);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->hashes);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, CONWAY_HASHES_SIZE / CONWAY_HASH_RING * slot,
+                             CONWAY_HASHES_SIZE / CONWAY_HASH_RING, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->stats);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, CONWAY_STATS_SIZE / CONWAY_HASH_RING * slot,
+                             CONWAY_STATS_SIZE / CONWAY_HASH_RING, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+        if (engine->topology == TOPOLOGY_MOBIUS) {
+            // copy the opposite edge, upside down, into the side padding of the board being read
+            glUseProgram(engine->edgesProgram);
+            glDispatchCompute(workGroups(engine->height), 1, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+        if (engine->ltl) {
+            // running sums along rows, then each invocation slides them down a band of 64 rows
+            glUseProgram(engine->rowSumProgram);
+            glDispatchCompute((engine->width + 63) / 64, workGroups(engine->height), 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            glUseProgram(engine->lifeProgram);
+            glUniform1i(0, slot);
+            glDispatchCompute((engine->stride / 4 + 63) / 64, (engine->height + 63) / 64, 1);
+        } else {
+            glUseProgram(engine->lifeProgram);
+            glUniform1i(0, slot);
+            // workgroups of 64 words along a row
+            glDispatchCompute((engine->stride / 4 + 63) / 64, workGroups(engine->height), 1);
+        }
+        // the hash slots are cleared by buffer commands
+        glMemoryBarrier(i + 1 < generations ? GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT
+                                            : GL_ALL_BARRIER_BITS);
+        ++engine->generation;
+    }
+}
+
+void conwayQuery(const st_conway *engine, st_conwayStats *stats) {
+    *stats = {};
+    stats->generation = engine->generation;
+    if (engine->generation >= engine->hashedFrom) {
+        unsigned int words[CONWAY_STATS_WORDS];
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->stats);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, CONWAY_STATS_SIZE / CONWAY_HASH_RING *
+                                                     (engine->generation % CONWAY_HASH_RING), sizeof(words), words);
+        stats->population = words[0];
+        stats->births = words[1];
+        stats->deaths = words[2];
+        // the kernels keep the complement of the top left corner, all bounds grow by max
+        if (words[5]) {
+            const int bounds[4] = {(int) ~words[3], (int) ~words[4], (int) words[5], (int) words[6]};
+            std::memcpy(stats->bounds, bounds, sizeof(bounds));
+        }
+        return;
+    }
+
+    std::vector<unsigned char> board(engine->boardSize);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, engine->boardSize, board.data());
+    for (int y = 0; y < engine->height; ++y) {
+        const unsigned char *row = board.data() + 1 + (size_t) (y + 1) * engine->stride;
+        for (int x = 0; x < engine->width; ++x) {
+            if (row[x] == 1) {
+                const bool first = stats->population++ == 0;
+                stats->bounds[0] = first ? x : std::min(stats->bounds[0], x);
+                stats->bounds[1] = first ? y : stats->bounds[1];
+                stats->bounds[2] = first ? x + 1 : std::max(stats->bounds[2], x + 1);
+                stats->bounds[3] = y + 1;
+            }
+        }
+    }
+}
+
+int conwayPeriod(const unsigned int *hashes, long long generation, long long first) {
+    auto hashOf = [hashes](long long g) {
+        const unsigned int *parts = hashes + (g % CONWAY_HASH_RING) * CONWAY_HASH_PARTS * 2;
+        uint32_t low = 0, high = 0;
+        for (int i = 0; i < CONWAY_HASH_PARTS; ++i) {
+            low += parts[2 * i];
+            high += parts[2 * i + 1];
+        }
+        return (uint64_t) high << 32 | low;
+    };
+    if (generation < first) {
+        return 0;
+    }
+    const uint64_t newest = hashOf(generation);
+    for (int period = 1; period < CONWAY_HASH_RING && generation - period >= first; ++period) {
+        if (hashOf(generation - period) == newest) {
+            return period;
+        }
+    }
+    return 0;
+}
+
+int conwayQueryPeriod(const st_conway *engine) {
+    std::vector<unsigned int> hashes(CONWAY_HASHES_SIZE / sizeof(unsigned int));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->hashes);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, CONWAY_HASHES_SIZE, hashes.data());
+    return conwayPeriod(hashes.data(), engine->generation, engine->hashedFrom);
+}
+
+void conwayJump(st_conway *engine, long long generations, int period) {
+    conwayStep(engine, (int) (generations % period));
+    // whole periods leave the board as it is, the hashes in the ring no longer line up with their generations
+    engine->generation += generations - generations % period;
+    engine->hashedFrom = engine->generation + 1;
+    ++engine->replacements;
+}
+
+int conwayImport(st_conway *engine, const unsigned char *cells, int stride, long long generation) {
+    if (stride < engine->width) {
+        std::cout << "ERROR::CONWAY::STRIDE_TOO_SHORT" << std::endl;
+        return 0;
+    }
+    std::vector<unsigned char> board(engine->boardSize, 0);
+    for (int y = 0; y < engine->height; ++y) {
+        std::memcpy(board.data() + 1 + (size_t) (y + 1) * engine->stride, cells + (size_t) y * stride,
+                    engine->width);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, engine->boardSize, board.data());
+    engine->generation = generation;
+    engine->hashedFrom = generation + 1;
+    ++engine->replacements;
+    return 1;
+}
+
+void conwayImportBoard(st_conway *engine, const unsigned char *board, long long generation) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, engine->boardSize, board);
+    engine->generation = generation;
+    engine->hashedFrom = generation + 1;
+    ++engine->replacements;
+}
+
+int conwayExport(const st_conway *engine, unsigned char *cells, int stride) {
+    if (stride < engine->width) {
+        std::cout << "ERROR::CONWAY::STRIDE_TOO_SHORT" << std::endl;
+        return 0;
+    }
+    std::vector<unsigned char> board(engine->boardSize);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, engine->board);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, engine->boardSize, board.data());
+    for (int y = 0; y < engine->height; ++y) {
+        std::memcpy(cells + (size_t) y * stride, board.data() + 1 + (size_t) (y + 1) * engine->stride,
+                    engine->width);
+    }
+    return 1;
+}
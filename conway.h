@@ -0,0 +1,96 @@
+#ifndef CONWAY_LIFE_CONWAY_H
+#define CONWAY_LIFE_CONWAY_H
+
+#include "rule.h"
+#include "checkpoint.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// GPU simulation engine shared by every frontend. The board lives in shader storage buffers, one byte of state per
+// cell, stride bytes per row, with a row and a column of padding on every side: cell (x, y) is byte
+// x + 1 + (y + 1) * stride of board. Frontends read board directly for drawing and asynchronous readbacks; everything
+// else goes through the functions below. All of them need the OpenGL 4.3 context current that the engine was
+// created in.
+// Every step also hashes the board it writes into slot generation % CONWAY_HASH_RING of the hashes buffer, as
+// CONWAY_HASH_PARTS partial sums of two 32-bit halves, so a board that repeats with a period of up to
+// CONWAY_HASH_RING - 1 is recognized from one small readback. The statistics of the generation go to the same slot of
+// the stats buffer, CONWAY_STATS_WORDS words each.
+const int CONWAY_HASH_RING = 64;
+const int CONWAY_HASH_PARTS = 64;
+const size_t CONWAY_HASHES_SIZE = (size_t) CONWAY_HASH_RING * CONWAY_HASH_PARTS * 2 * sizeof(unsigned int);
+const int CONWAY_STATS_WORDS = 8;
+const size_t CONWAY_STATS_SIZE = (size_t) CONWAY_HASH_RING * CONWAY_STATS_WORDS * sizeof(unsigned int);
+
+struct st_conway {
+    int width;
+    int height;
+    int stride;
+    size_t boardSize;
+    int topology;
+    bool ltl;
+    st_rule rule;
+    st_ltlRule ltlRule;
+    char ruleName[128];
+    long long generation;
+    long long hashedFrom;  // oldest generation with a hash and statistics since the board was last replaced
+    long long replacements;  // times the board was seeded, imported or jumped, a reseed can leave hashedFrom as it was
+    unsigned int lifeProgram;
+    unsigned int rowSumProgram;
+    unsigned int edgesProgram;
+    unsigned int seedProgram;
+    unsigned int params;
+    unsigned int board;  // newest generation, bound to 1
+    unsigned int previous;  // bound to 2
+    unsigned int rowSums;  // bound to 3
+    unsigned int hashes;  // bound to 4
+    unsigned int stats;  // bound to 5
+};
+
+struct st_conwayStats {
+    long long generation;
+    long long population;  // cells in state 1
+    long long births;  // cells that went from state 0 to 1 in the last step
+    long long deaths;  // cells that left state 1 in the last step
+    int bounds[4];  // live cells are in [bounds[0], bounds[2]) x [bounds[1], bounds[3]), all 0 when there are none
+};
+
+// Parses rule (B/S or Larger than Life), builds its kernels and an empty board. Möbius boards join the left and
+// right edges with a half twist and support every rule but Larger than Life.
+int conwayCreate(st_conway *engine, int width, int height, int topology, const char *rule);
+
+void conwayDestroy(st_conway *engine);
+
+// Fills the board with a reproducible random soup, density the share of live cells, at generation 0. Runs on the GPU
+// and matches seedCells for the same seed and density bit for bit.
+void conwaySeed(st_conway *engine, uint64_t seed, double density);
+
+// Advances the board by generations. Only queues GPU work, the board may be read by shaders and buffer copies as soon
+// as this returns.
+void conwayStep(st_conway *engine, int generations);
+
+// Waits for the GPU and reads the statistics the last step gathered. Right after a seed or an import, which have none,
+// the board is counted instead, with no births or deaths.
+void conwayQuery(const st_conway *engine, st_conwayStats *stats);
+
+// Smallest period the board at generation repeats with, 0 when it does not repeat within the ring. hashes is the
+// hashes buffer as read back when generation was the newest, first the hashedFrom of the engine at the time.
+int conwayPeriod(const unsigned int *hashes, long long generation, long long first);
+
+// Waits for the GPU, then conwayPeriod of the current board
+int conwayQueryPeriod(const st_conway *engine);
+
+// Advances a board known to repeat every period generations by generations, stepping only generations % period of
+// them on the GPU
+void conwayJump(st_conway *engine, long long generations, int period);
+
+// Replaces the board, cells pointing at cell (0, 0) with rows stride bytes apart
+int conwayImport(st_conway *engine, const unsigned char *cells, int stride, long long generation);
+
+// Replaces the whole board buffer, padding included, with board laid out as st_conway::board, in one upload
+void conwayImportBoard(st_conway *engine, const unsigned char *board, long long generation);
+
+// Waits for the GPU and copies the board out, same layout as conwayImport
+int conwayExport(const st_conway *engine, unsigned char *cells, int stride);
+
+#endif
@@ -0,0 +1,489 @@
+#include "cpuLife.h"
+#include "parallel.h"
+#include "numaPlacement.h"
+#include "boardMemory.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <utility>
+
+static const size_t FIRST_TOUCH_BYTES = 4 << 20;
+
+int createLifeBoard(st_lifeBoard *board, int width, int height, int states) {
+    board->width = width;
+    board->height = height;
+    board->states = states;
+    board->wordsPerRow = (width + 63) / 64;
+    // the decay counter runs 1 .. states - 2
+    board->planes = 1;
+    while (states > 2 && (states - 2) >> (board->planes - 1)) {
+        ++board->planes;
+    }
+    const size_t size = lifeBoardSize(board);
+    board->cells = (uint64_t *) allocateBoard(size);
+    if (!board->cells) {
+        std::cout << "ERROR::CPU_LIFE::ALLOCATION_FAILED" << std::endl;
+        return 0;
+    }
+    // large boards are first touched band by band by threads pinned as for stepping, so each band lands on its node
+    parallelFor(height + 2, size >= FIRST_TOUCH_BYTES ? 0 : 1, [=](int begin, int end) {
+        const size_t bytes = (size_t) (end - begin) * board->wordsPerRow * sizeof(uint64_t);
+        for (int p = 0; p < board->planes; ++p) {
+            char *rows = (char *) lifePlaneRow(board, p, begin - 1);
+            // whole huge pages only, binding part of one keeps it from being backed by a huge page
+            const uintptr_t first = ((uintptr_t) rows + BOARD_HUGE_PAGE - 1) / BOARD_HUGE_PAGE * BOARD_HUGE_PAGE;
+            const uintptr_t last = ((uintptr_t) rows + bytes) / BOARD_HUGE_PAGE * BOARD_HUGE_PAGE;
+            if (last > first) {
+                bindMemory((void *) first, last - first, currentNumaNode());
+            }
+            memset(rows, 0, bytes);
+        }
+    });
+    return 1;
+}
+
+void destroyLifeBoard(st_lifeBoard *board) {
+    freeBoard(board->cells, lifeBoardSize(board));
+    board->cells = nullptr;
+}
+
+// west/east neighbor of every cell in word x, shifted in from the adjacent words
+static inline uint64_t westOf(const uint64_t *row, int x) {
+    return (row[x] << 1) | (x > 0 ? row[x - 1] >> 63 : 0);
+}
+
+static inline uint64_t eastOf(const uint64_t *row, int x, int words) {
+    return (row[x] >> 1) | (x + 1 < words ? row[x + 1] << 63 : 0);
+}
+
+// SUM_BITS is the plane count of the neighborhood, known at compile time for the unweighted ones
+template<int SUM_BITS>
+static inline uint64_t applyCircuit(const st_ruleCircuit *circuit, uint64_t alive, const uint64_t *sum) {
+    const int sumBits = SUM_BITS ? SUM_BITS : circuit->sumBits;
+    uint64_t result = 0;
+    for (int i = 0; i < circuit->termCount; ++i) {
+        int n = circuit->terms[i].count;
+        uint64_t term = ~0ull;
+        for (int j = 0; j < sumBits; ++j) {
+            term &= (n >> j) & 1 ? sum[j] : ~sum[j];
+        }
+        switch (circuit->terms[i].when) {
+            case st_ruleCircuit::DEAD:
+                term &= ~alive;
+                break;
+            case st_ruleCircuit::ALIVE:
+                term &= alive;
+                break;
+            default:
+                break;
+        }
+        result |= term;
+    }
+    return result;
+}
+
+// Moore rules with straight-line kernels, birth and survive as in st_rule. Any other rule runs the terms of its circuit.
+struct st_compiledRule {
+    unsigned int birth;
+    unsigned int survive;
+};
+
+static constexpr st_compiledRule COMPILED_RULES[] = {{0x8, 0xc},  // B3/S23
+                                                     {0x48, 0xc},  // B36/S23
+                                                     {0x1c8, 0x1d8},  // B3678/S34678
+                                                     {0x4, 0},  // B2/S, also Brian's Brain
+                                                     {0x8, 0x1ff},  // B3/S012345678
+                                                     {0xaa, 0xaa}};  // B1357/S1357
+static const int COMPILED_RULE_COUNT = sizeof(COMPILED_RULES) / sizeof(COMPILED_RULES[0]);
+
+// the product term of count N, folded away at compile time when no cell with N neighbors is alive next
+template<unsigned int BIRTH, unsigned int SURVIVE, int N>
+static inline uint64_t countTerm(uint64_t alive, const uint64_t *sum) {
+    constexpr bool birth = (BIRTH >> N) & 1, survive = (SURVIVE >> N) & 1;
+    if constexpr (!birth && !survive) {
+        return 0;
+    } else {
+        const uint64_t term = (N & 1 ? sum[0] : ~sum[0]) & (N & 2 ? sum[1] : ~sum[1]) &
+                              (N & 4 ? sum[2] : ~sum[2]) & (N & 8 ? sum[3] : ~sum[3]);
+        return birth && survive ? term : birth ? term & ~alive : term & alive;
+    }
+}
+
+template<int RULE, int... N>
+static inline uint64_t applyCompiled(uint64_t alive, const uint64_t *sum, std::integer_sequence<int, N...>) {
+    return (countTerm<COMPILED_RULES[RULE].birth, COMPILED_RULES[RULE].survive, N>(alive, sum) | ...);
+}
+
+// index into COMPILED_RULES, -1 when the circuit is not one of them
+static int compiledRule(const st_ruleCircuit *circuit) {
+    if (circuit->neighborhood != NEIGHBORHOOD_MOORE) {
+        return -1;
+    }
+    unsigned int birth = 0, survive = 0;
+    for (int i = 0; i < circuit->termCount; ++i) {
+        birth |= circuit->terms[i].when & st_ruleCircuit::DEAD ? 1u << circuit->terms[i].count : 0;
+        survive |= circuit->terms[i].when & st_ruleCircuit::ALIVE ? 1u << circuit->terms[i].count : 0;
+    }
+    for (int i = 0; i < COMPILED_RULE_COUNT; ++i) {
+        if (COMPILED_RULES[i].birth == birth && COMPILED_RULES[i].survive == survive) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static inline void fullAdd(uint64_t *sum, uint64_t *carry, uint64_t a, uint64_t b, uint64_t c) {
+    *sum = a ^ b ^ c;
+    *carry = (a & b) | (c & (a ^ b));
+}
+
+// bit-sliced neighbor count of the 64 cells in word x of the middle row, one adder network per neighborhood
+template<int NEIGHBORHOOD>
+static inline void countNeighbors(uint64_t *sum, const st_ruleCircuit *circuit, const uint64_t *above,
+                                  const uint64_t *middle, const uint64_t *below, int x, int words) {
+    if constexpr (NEIGHBORHOOD == NEIGHBORHOOD_MOORE) {
+        // full adders per row, then sum the three partial counts
+        uint64_t u0, u1, l0, l1, c0, x0, x1;
+        fullAdd(&u0, &u1, westOf(above, x), above[x], eastOf(above, x, words));
+        fullAdd(&l0, &l1, westOf(below, x), below[x], eastOf(below, x, words));
+        uint64_t a = westOf(middle, x), c = eastOf(middle, x, words);
+        uint64_t m0 = a ^ c, m1 = a & c;
+        fullAdd(&sum[0], &c0, u0, l0, m0);
+        fullAdd(&x0, &x1, u1, l1, m1);
+        sum[1] = x0 ^ c0;
+        uint64_t y1 = x0 & c0;
+        sum[2] = x1 ^ y1;
+        sum[3] = x1 & y1;
+    } else if constexpr (NEIGHBORHOOD == NEIGHBORHOOD_HEXAGONAL) {
+        // NW, N, W and E, S, SE
+        uint64_t p0, p1, q0, q1;
+        fullAdd(&p0, &p1, westOf(above, x), above[x], westOf(middle, x));
+        fullAdd(&q0, &q1, eastOf(middle, x, words), below[x], eastOf(below, x, words));
+        sum[0] = p0 ^ q0;
+        fullAdd(&sum[1], &sum[2], p1, q1, p0 & q0);
+    } else if constexpr (NEIGHBORHOOD == NEIGHBORHOOD_VON_NEUMANN) {
+        uint64_t n = above[x], s = below[x], w = westOf(middle, x), e = eastOf(middle, x, words);
+        sum[0] = n ^ s ^ w ^ e;
+        fullAdd(&sum[1], &sum[2], n & s, w & e, (n ^ s) & (w ^ e));
+    } else {
+        // add every neighbor into the sum planes once per set bit of its weight
+        const uint64_t neighbors[8] = {westOf(above, x), above[x], eastOf(above, x, words),
+                                       westOf(middle, x), eastOf(middle, x, words),
+                                       westOf(below, x), below[x], eastOf(below, x, words)};
+        for (int j = 0; j < circuit->sumBits; ++j) {
+            sum[j] = 0;
+        }
+        for (int k = 0; k < 8; ++k) {
+            for (int bit = 0; circuit->weights[k] >> bit; ++bit) {
+                if ((circuit->weights[k] >> bit) & 1) {
+                    uint64_t carry = neighbors[k];
+                    for (int j = bit; j < circuit->sumBits; ++j) {
+                        uint64_t next = sum[j] & carry;
+                        sum[j] ^= carry;
+                        carry = next;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Generations: decaying cells cannot be born and step through states 2 .. states - 1 before they are dead again.
+// Live cells that did not survive start decaying at state 2.
+static void stepDecay(st_lifeBoard *next, const st_lifeBoard *current, int y) {
+    const int words = current->wordsPerRow, planes = current->planes, lastCounter = current->states - 2;
+    const uint64_t *alive = lifeRow(current, y);
+    uint64_t *nextAlive = lifeRow(next, y);
+
+    for (int x = 0; x < words; ++x) {
+        uint64_t decaying = 0, wrap = ~0ull;
+        for (int p = 1; p < planes; ++p) {
+            uint64_t bits = lifePlaneRow(current, p, y)[x];
+            decaying |= bits;
+            wrap &= (lastCounter >> (p - 1)) & 1 ? bits : ~bits;
+        }
+        wrap &= decaying;
+        nextAlive[x] &= ~decaying;
+
+        // bit-sliced increment of the counter of every decaying cell
+        uint64_t carry = decaying, start = alive[x] & ~nextAlive[x];
+        for (int p = 1; p < planes; ++p) {
+            uint64_t bits = lifePlaneRow(current, p, y)[x];
+            uint64_t counter = (bits ^ carry) & ~wrap;
+            carry &= bits;
+            lifePlaneRow(next, p, y)[x] = p == 1 ? counter | start : counter;
+        }
+    }
+}
+
+// adds row y of the generation written, after, given the live cells it was stepped from, before
+static void addRowStats(st_lifeStats *stats, const uint64_t *before, const uint64_t *after, int words, int y) {
+    int left = -1, right = -1;
+    for (int x = 0; x < words; ++x) {
+        stats->population += std::popcount(after[x]);
+        stats->births += std::popcount(after[x] & ~before[x]);
+        stats->deaths += std::popcount(before[x] & ~after[x]);
+        if (after[x]) {
+            left = left < 0 ? 64 * x + std::countr_zero(after[x]) : left;
+            right = 64 * x + 64 - std::countl_zero(after[x]);
+        }
+    }
+    if (left >= 0) {
+        const bool first = stats->bounds[2] == 0;
+        stats->bounds[0] = first ? left : std::min(stats->bounds[0], left);
+        stats->bounds[1] = first ? y : std::min(stats->bounds[1], y);
+        stats->bounds[2] = std::max(stats->bounds[2], right);
+        stats->bounds[3] = std::max(stats->bounds[3], y + 1);
+    }
+}
+
+static void mergeStats(st_lifeStats *into, const st_lifeStats *from) {
+    into->population += from->population;
+    into->births += from->births;
+    into->deaths += from->deaths;
+    if (from->bounds[2]) {
+        const bool first = into->bounds[2] == 0;
+        for (int i = 0; i < 2; ++i) {
+            into->bounds[i] = first ? from->bounds[i] : std::min(into->bounds[i], from->bounds[i]);
+            into->bounds[i + 2] = std::max(into->bounds[i + 2], from->bounds[i + 2]);
+        }
+    }
+}
+
+// RULE indexes COMPILED_RULES, -1 runs the terms of circuit
+template<int NEIGHBORHOOD, int RULE>
+static void stepRows(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit,
+                     int begin, int end, st_lifeStats *stats) {
+    const int words = current->wordsPerRow;
+    const uint64_t lastMask = current->width & 63 ? (1ull << (current->width & 63)) - 1 : ~0ull;
+
+    for (int y = begin; y < end; ++y) {
+        const uint64_t *above = lifeRow(current, y - 1);
+        const uint64_t *middle = lifeRow(current, y);
+        const uint64_t *below = lifeRow(current, y + 1);
+        uint64_t *out = lifeRow(next, y);
+
+        for (int x = 0; x < words; ++x) {
+            uint64_t sum[5];
+            countNeighbors<NEIGHBORHOOD>(sum, circuit, above, middle, below, x, words);
+            if constexpr (RULE >= 0) {
+                out[x] = applyCompiled<RULE>(middle[x], sum, std::make_integer_sequence<int, 9>());
+            } else {
+                out[x] = applyCircuit<NEIGHBORHOOD == NEIGHBORHOOD_MOORE ? 4
+                                      : NEIGHBORHOOD == NEIGHBORHOOD_WEIGHTED ? 0 : 3>(circuit, middle[x], sum);
+            }
+        }
+        out[words - 1] &= lastMask;
+
+        if (current->planes > 1) {
+            stepDecay(next, current, y);
+        }
+        if (stats) {
+            addRowStats(stats, middle, out, words, y);
+        }
+    }
+}
+
+typedef void (*stepRowsKernel)(st_lifeBoard *, const st_lifeBoard *, const st_ruleCircuit *, int, int,
+                               st_lifeStats *);
+
+template<int... RULE>
+static const stepRowsKernel *compiledKernels(std::integer_sequence<int, RULE...>) {
+    static const stepRowsKernel kernels[] = {stepRows<NEIGHBORHOOD_MOORE, RULE>...};
+    return kernels;
+}
+
+static void stepNeighborhoodRows(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit,
+                                 int begin, int end, st_lifeStats *stats) {
+    switch (circuit->neighborhood) {
+        case NEIGHBORHOOD_HEXAGONAL:
+            stepRows<NEIGHBORHOOD_HEXAGONAL, -1>(next, current, circuit, begin, end, stats);
+            break;
+        case NEIGHBORHOOD_VON_NEUMANN:
+            stepRows<NEIGHBORHOOD_VON_NEUMANN, -1>(next, current, circuit, begin, end, stats);
+            break;
+        case NEIGHBORHOOD_WEIGHTED:
+            stepRows<NEIGHBORHOOD_WEIGHTED, -1>(next, current, circuit, begin, end, stats);
+            break;
+        default: {
+            const int rule = compiledRule(circuit);
+            if (rule >= 0) {
+                compiledKernels(std::make_integer_sequence<int, COMPILED_RULE_COUNT>())[rule](next, current, circuit,
+                                                                                            begin, end, stats);
+            } else {
+                stepRows<NEIGHBORHOOD_MOORE, -1>(next, current, circuit, begin, end, stats);
+            }
+            break;
+        }
+    }
+}
+
+void stepLife(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit, int threads,
+              st_lifeStats *stats) {
+    // every band counts its own rows and adds them in once
+    std::mutex mutex;
+    if (stats) {
+        *stats = {};
+    }
+    parallelFor(current->height, threads, [&](int begin, int end) {
+        st_lifeStats band = {};
+        stepNeighborhoodRows(next, current, circuit, begin, end, stats ? &band : nullptr);
+        if (stats) {
+            std::lock_guard<std::mutex> lock(mutex);
+            mergeStats(stats, &band);
+        }
+    });
+}
+
+template<int NEIGHBORHOOD>
+static void stepColumn(uint64_t *out, const uint64_t *west, const uint64_t *middle, const uint64_t *east, int rows,
+                       const st_ruleCircuit *circuit) {
+    for (int y = 0; y < rows; ++y) {
+        // the three words of each row as a three word board, stepping its middle word
+        const uint64_t above[3] = {west[y], middle[y], east[y]};
+        const uint64_t center[3] = {west[y + 1], middle[y + 1], east[y + 1]};
+        const uint64_t below[3] = {west[y + 2], middle[y + 2], east[y + 2]};
+        uint64_t sum[5];
+        countNeighbors<NEIGHBORHOOD>(sum, circuit, above, center, below, 1, 3);
+        out[y] = applyCircuit<NEIGHBORHOOD == NEIGHBORHOOD_MOORE ? 4 : NEIGHBORHOOD == NEIGHBORHOOD_WEIGHTED ? 0 : 3>(
+                circuit, center[1], sum);
+    }
+}
+
+void stepLifeColumn(uint64_t *out, const uint64_t *west, const uint64_t *middle, const uint64_t *east, int rows,
+                    const st_ruleCircuit *circuit) {
+    switch (circuit->neighborhood) {
+        case NEIGHBORHOOD_HEXAGONAL:
+            stepColumn<NEIGHBORHOOD_HEXAGONAL>(out, west, middle, east, rows, circuit);
+            break;
+        case NEIGHBORHOOD_VON_NEUMANN:
+            stepColumn<NEIGHBORHOOD_VON_NEUMANN>(out, west, middle, east, rows, circuit);
+            break;
+        case NEIGHBORHOOD_WEIGHTED:
+            stepColumn<NEIGHBORHOOD_WEIGHTED>(out, west, middle, east, rows, circuit);
+            break;
+        default:
+            stepColumn<NEIGHBORHOOD_MOORE>(out, west, middle, east, rows, circuit);
+            break;
+    }
+}
+
+int stepLifeRange(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit, int begin, int end) {
+    stepNeighborhoodRows(next, current, circuit, begin, end, nullptr);
+    return end;
+}
+
+// The isotropic kernel runs this many words of a row through each step before the next step, so that every loop over
+// them vectorizes
+static const int ISOTROPIC_CHUNK = 32;
+
+static void stepIsotropicRows(st_lifeBoard *next, const st_lifeBoard *current, const st_isotropicTable *table,
+                              int begin, int end, st_lifeStats *stats) {
+    const int words = current->wordsPerRow;
+    const uint64_t lastMask = current->width & 63 ? (1ull << (current->width & 63)) - 1 : ~0ull;
+    // the three rows of the chunk with the word before and after it, then the nine cells of the neighborhood in the
+    // bit order of st_rule, the bit-planes of the count and the values of the diagrams: false, true and one per node
+    uint64_t rows[3][ISOTROPIC_CHUNK + 2], cells[9][ISOTROPIC_CHUNK], sum[4][ISOTROPIC_CHUNK];
+    uint64_t result[ISOTROPIC_CHUNK], node[ISOTROPIC_CHUNK];
+    std::vector<uint64_t> values(2 * ISOTROPIC_CHUNK, ~0ull);
+    std::fill(values.begin(), values.begin() + ISOTROPIC_CHUNK, 0);
+    values.resize((size_t) (table->nodeCount + 2) * ISOTROPIC_CHUNK);
+
+    for (int y = begin; y < end; ++y) {
+        uint64_t *out = lifeRow(next, y);
+        for (int first = 0; first < words; first += ISOTROPIC_CHUNK) {
+            // past the end of the row the chunk is padded with dead words and only the words of the row are stored
+            const int count = std::min(ISOTROPIC_CHUNK, words - first);
+            for (int r = 0; r < 3; ++r) {
+                const uint64_t *row = lifeRow(current, y - 1 + r);
+                if (count < ISOTROPIC_CHUNK) {
+                    std::fill(rows[r], rows[r] + ISOTROPIC_CHUNK + 2, 0);
+                }
+                std::copy(row + first, row + first + count, rows[r] + 1);
+                rows[r][0] = first > 0 ? row[first - 1] : 0;
+                rows[r][count + 1] = first + count < words ? row[first + count] : 0;
+                for (int i = 0; i < ISOTROPIC_CHUNK; ++i) {
+                    cells[3 * r][i] = (rows[r][i + 1] << 1) | (rows[r][i] >> 63);
+                    cells[3 * r + 1][i] = rows[r][i + 1];
+                    cells[3 * r + 2][i] = (rows[r][i + 1] >> 1) | (rows[r][i + 2] << 63);
+                }
+            }
+
+            // the Moore adder of countNeighbors
+            for (int i = 0; i < ISOTROPIC_CHUNK; ++i) {
+                uint64_t u0, u1, l0, l1, c0, x0, x1;
+                fullAdd(&u0, &u1, cells[0][i], cells[1][i], cells[2][i]);
+                fullAdd(&l0, &l1, cells[6][i], cells[7][i], cells[8][i]);
+                const uint64_t m0 = cells[3][i] ^ cells[5][i], m1 = cells[3][i] & cells[5][i];
+                fullAdd(&sum[0][i], &c0, u0, l0, m0);
+                fullAdd(&x0, &x1, u1, l1, m1);
+                sum[1][i] = x0 ^ c0;
+                const uint64_t y1 = x0 & c0;
+                sum[2][i] = x1 ^ y1;
+                sum[3][i] = x1 & y1;
+                result[i] = 0;
+            }
+
+            for (int k = 0; k < table->nodeCount; ++k) {
+                const uint64_t *input = cells[table->nodes[k].neighbor];
+                const uint64_t *low = &values[(size_t) table->nodes[k].low * ISOTROPIC_CHUNK];
+                const uint64_t *high = &values[(size_t) table->nodes[k].high * ISOTROPIC_CHUNK];
+                for (int i = 0; i < ISOTROPIC_CHUNK; ++i) {
+                    node[i] = low[i] ^ (input[i] & (low[i] ^ high[i]));
+                }
+                std::copy(node, node + ISOTROPIC_CHUNK, &values[(size_t) (k + 2) * ISOTROPIC_CHUNK]);
+            }
+
+            // every count with a live cell next, as in applyCircuit, picking the diagram of the dead or live center
+            for (int n = 0; n <= 8; ++n) {
+                if (!table->roots[n][0] && !table->roots[n][1]) {
+                    continue;
+                }
+                const uint64_t *dead = &values[(size_t) table->roots[n][0] * ISOTROPIC_CHUNK];
+                const uint64_t *alive = &values[(size_t) table->roots[n][1] * ISOTROPIC_CHUNK];
+                const uint64_t flip0 = n & 1 ? 0 : ~0ull, flip1 = n & 2 ? 0 : ~0ull, flip2 = n & 4 ? 0 : ~0ull;
+                const uint64_t flip3 = n & 8 ? 0 : ~0ull;
+                for (int i = 0; i < ISOTROPIC_CHUNK; ++i) {
+                    result[i] |= (sum[0][i] ^ flip0) & (sum[1][i] ^ flip1) & (sum[2][i] ^ flip2) & (sum[3][i] ^ flip3) &
+                                 (dead[i] ^ (cells[4][i] & (dead[i] ^ alive[i])));
+                }
+            }
+            std::copy(result, result + count, out + first);
+        }
+        out[words - 1] &= lastMask;
+
+        if (current->planes > 1) {
+            stepDecay(next, current, y);
+        }
+        if (stats) {
+            addRowStats(stats, lifeRow(current, y), out, words, y);
+        }
+    }
+}
+
+void stepIsotropic(st_lifeBoard *next, const st_lifeBoard *current, const st_isotropicTable *table, int threads,
+                   st_lifeStats *stats) {
+    std::mutex mutex;
+    if (stats) {
+        *stats = {};
+    }
+    parallelFor(current->height, threads, [&](int begin, int end) {
+        st_lifeStats band = {};
+        stepIsotropicRows(next, current, table, begin, end, stats ? &band : nullptr);
+        if (stats) {
+            std::lock_guard<std::mutex> lock(mutex);
+            mergeStats(stats, &band);
+        }
+    });
+}
+
+int stepIsotropicRange(st_lifeBoard *next, const st_lifeBoard *current, const st_isotropicTable *table, int begin,
+                       int end) {
+    stepIsotropicRows(next, current, table, begin, end, nullptr);
+    return end;
+}
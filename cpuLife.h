@@ -0,0 +1,86 @@
+#ifndef CONWAY_LIFE_CPU_LIFE_H
+#define CONWAY_LIFE_CPU_LIFE_H
+
+#include "rule.h"
+
+#include <cstdint>
+#include <cstddef>
+
+// Bit-packed board, 64 cells per word. Rows 0 and height + 1 are the dead padding ring above and below the board,
+// cells left and right of it are read as dead. Bits past width in the last word of a row are always zero.
+// Plane 0 holds the live cells. Generations rules add bit-planes for a decay counter: a cell in state s >= 2 has
+// counter s - 1 and a clear live bit.
+struct st_lifeBoard {
+    int width;
+    int height;
+    int states;
+    int wordsPerRow;
+    int planes;
+    uint64_t *cells;
+};
+
+int createLifeBoard(st_lifeBoard *board, int width, int height, int states);
+
+void destroyLifeBoard(st_lifeBoard *board);
+
+// Bytes of cells, every plane with its padding rows
+inline size_t lifeBoardSize(const st_lifeBoard *board) {
+    return (size_t) board->planes * (board->height + 2) * board->wordsPerRow * sizeof(uint64_t);
+}
+
+inline uint64_t *lifePlaneRow(const st_lifeBoard *board, int plane, int y) {
+    return board->cells + ((long long) plane * (board->height + 2) + y + 1) * board->wordsPerRow;
+}
+
+inline uint64_t *lifeRow(const st_lifeBoard *board, int y) {
+    return lifePlaneRow(board, 0, y);
+}
+
+inline int getCell(const st_lifeBoard *board, int x, int y) {
+    int state = (int) (lifeRow(board, y)[x >> 6] >> (x & 63)) & 1, counter = 0;
+    for (int p = 1; p < board->planes; ++p) {
+        counter |= (int) ((lifePlaneRow(board, p, y)[x >> 6] >> (x & 63)) & 1) << (p - 1);
+    }
+    return counter ? counter + 1 : state;
+}
+
+inline void setCell(st_lifeBoard *board, int x, int y, int state) {
+    uint64_t bit = 1ull << (x & 63);
+    int counter = state >= 2 ? state - 1 : 0;
+    for (int p = 0; p < board->planes; ++p) {
+        uint64_t *word = lifePlaneRow(board, p, y) + (x >> 6);
+        int set = p == 0 ? state == 1 : (counter >> (p - 1)) & 1;
+        *word = set ? *word | bit : *word & ~bit;
+    }
+}
+
+// Counts of the generation a step writes, the same as st_conwayStats
+struct st_lifeStats {
+    long long population;  // cells in state 1
+    long long births;  // cells that went from state 0 to 1
+    long long deaths;  // cells that left state 1
+    int bounds[4];  // live cells are in [bounds[0], bounds[2]) x [bounds[1], bounds[3]), all 0 when there are none
+};
+
+// Advances current by one generation into next, which must have the same dimensions. Unless stats is null it is
+// filled in from the rows while they are still in cache.
+void stepLife(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit, int threads,
+              st_lifeStats *stats);
+
+// Same for isotropic non-totalistic rules, bit-sliced like the totalistic kernel with the diagrams of the table on top.
+void stepIsotropic(st_lifeBoard *next, const st_lifeBoard *current, const st_isotropicTable *table, int threads,
+                   st_lifeStats *stats);
+
+// Next generation of a column of rows cells 64 wide, for boards kept in tiles. west, middle and east hold rows + 2
+// words each, from the row above the column to the row below it, of the column and the columns left and right of it.
+void stepLifeColumn(uint64_t *out, const uint64_t *west, const uint64_t *middle, const uint64_t *east, int rows,
+                    const st_ruleCircuit *circuit);
+
+// Single-threaded steps of rows [begin, end) only, for mostly empty boards; the rest of next is left as it is.
+// Returns the end of the rows written.
+int stepLifeRange(st_lifeBoard *next, const st_lifeBoard *current, const st_ruleCircuit *circuit, int begin, int end);
+
+int stepIsotropicRange(st_lifeBoard *next, const st_lifeBoard *current, const st_isotropicTable *table, int begin,
+                       int end);
+
+#endif
@@ -0,0 +1,41 @@
+#include "diskLife.h"
+
+#include <cstdint>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+
+// Boards larger than memory, stepped on the CPU straight from a file. An existing FILE is picked up where it was left,
+// otherwise a WIDTH x HEIGHT board is created and seeded from SEED. The file is as large as two bit-packed boards.
+
+const char *FILE_NAME = "board.life";
+const int WIDTH = 1 << 20;
+const int HEIGHT = 1 << 20;
+const char *RULE = "B3/S23";
+const uint64_t SEED = 1;
+const double DENSITY = 0.5;
+const int GENERATIONS = 10;
+const int THREADS = 0;  // every hardware thread
+
+int main() {
+    st_diskLife board;
+    if (std::filesystem::exists(FILE_NAME)) {
+        if (!openDiskLife(&board, FILE_NAME)) {
+            return -1;
+        }
+        std::cout << "Continuing from generation " << board.header->generation << std::endl;
+    } else if (createDiskLife(&board, FILE_NAME, WIDTH, HEIGHT, RULE)) {
+        seedDiskLife(&board, SEED, DENSITY, THREADS);
+    } else {
+        return -1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    stepDiskLife(&board, GENERATIONS, THREADS);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Generation " << board.header->generation << ", " << GENERATIONS / seconds << " generations/s, "
+              << (double) board.header->width * board.header->height * GENERATIONS / seconds / 1e9 << " Gcells/s"
+              << std::endl;
+    closeDiskLife(&board);
+    return 0;
+}
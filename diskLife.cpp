@@ -0,0 +1,205 @@
+#include "diskLife.h"
+#include "mapping.h"
+#include "parallel.h"
+#include "soup.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+static const char MAGIC[8] = {'C', 'O', 'N', 'W', 'A', 'Y', 'D', 'L'};
+
+static void boardView(const st_diskLife *board, int index, st_lifeBoard *view) {
+    const st_diskLifeHeader *header = board->header;
+    view->width = header->width;
+    view->height = header->height;
+    view->states = 2;
+    view->wordsPerRow = header->wordsPerRow;
+    view->planes = 1;
+    view->cells = (uint64_t *) ((char *) board->mapping + DISK_LIFE_ALIGNMENT + index * header->boardSize);
+}
+
+// byte offset of row y of a board in the mapping, rows -1 and height are the padding
+static size_t rowOffset(const st_diskLife *board, int index, int y) {
+    const st_diskLifeHeader *header = board->header;
+    return DISK_LIFE_ALIGNMENT + index * header->boardSize + (size_t) (y + 1) * header->wordsPerRow * sizeof(uint64_t);
+}
+
+// Runs band(begin, end) over the rows of each band in turn, split across threads, while reading ahead in board
+// source, if any, and retiring the bands behind in source and in target
+static void sweepDiskLife(st_diskLife *board, int source, int target, int threads,
+                          const std::function<void(int, int)> &band) {
+    const int height = board->header->height, rows = board->bandRows;
+    int retired = -1;
+    for (int top = 0; top < height; top += rows) {
+        const int bottom = std::min(top + rows, height);
+        if (source >= 0) {
+            adviseMapping(board->mapping, rowOffset(board, source, bottom),
+                          rowOffset(board, source, std::min(bottom + rows + 1, height + 1)) -
+                          rowOffset(board, source, bottom), MAPPING_WILL_NEED);
+        }
+        parallelFor(bottom - top, threads, [&](int begin, int end) {
+            band(top + begin, top + end);
+        });
+        flushMapping(board->mapping, rowOffset(board, target, top), rowOffset(board, target, bottom) -
+                                                                   rowOffset(board, target, top));
+
+        // the rows above the last one of the band are done with, it is the row above the next band
+        const int keep = bottom - 1;
+        if (keep > retired) {
+            for (int index : {source, target}) {
+                if (index >= 0) {
+                    adviseMapping(board->mapping, rowOffset(board, index, retired),
+                                  rowOffset(board, index, keep) - rowOffset(board, index, retired), MAPPING_DONT_NEED);
+                }
+            }
+            retired = keep;
+        }
+    }
+}
+
+static int mapDiskLife(st_diskLife *board, const char *file, size_t size) {
+    board->mapping = mapFileWritable(file, size);
+    board->mappingSize = size;
+    board->header = (st_diskLifeHeader *) board->mapping;
+    if (!board->mapping) {
+        std::cout << "ERROR::DISK_LIFE::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+    adviseMapping(board->mapping, 0, size, MAPPING_SEQUENTIAL);
+    return 1;
+}
+
+// Checks the rule and sizes the bands once the header is in place
+static int prepareDiskLife(st_diskLife *board) {
+    const st_diskLifeHeader *header = board->header;
+    if (!parseRule(&board->rule, header->rule) || board->rule.states != 2) {
+        std::cout << "ERROR::DISK_LIFE::UNSUPPORTED_RULE" << std::endl;
+        std::cout << header->rule << std::endl;
+        return 0;
+    }
+    compileRule(&board->circuit, &board->rule);
+    if (board->rule.isotropic) {
+        board->table = new st_isotropicTable;
+        compileIsotropic(board->table, &board->rule);
+    }
+    const size_t rowBytes = (size_t) header->wordsPerRow * sizeof(uint64_t);
+    board->bandRows = (int) std::min<size_t>(std::max<size_t>(DISK_LIFE_BAND_BYTES / rowBytes, 2), header->height + 1);
+    return 1;
+}
+
+int createDiskLife(st_diskLife *board, const char *file, int width, int height, const char *rule) {
+    *board = {};
+    st_diskLifeHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = DISK_LIFE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.wordsPerRow = (width + 63) / 64;
+    header.boardSize = ((uint64_t) (height + 2) * header.wordsPerRow * sizeof(uint64_t) + DISK_LIFE_ALIGNMENT - 1) /
+                       DISK_LIFE_ALIGNMENT * DISK_LIFE_ALIGNMENT;
+    if (std::strlen(rule) >= sizeof(header.rule)) {
+        std::cout << "ERROR::DISK_LIFE::UNSUPPORTED_RULE" << std::endl;
+        std::cout << rule << std::endl;
+        return 0;
+    }
+    std::strcpy(header.rule, rule);
+
+    // a file left over from an earlier board must not keep its cells
+    std::remove(file);
+    if (!mapDiskLife(board, file, DISK_LIFE_ALIGNMENT + 2 * header.boardSize)) {
+        return 0;
+    }
+    *board->header = header;
+    if (!prepareDiskLife(board)) {
+        closeDiskLife(board);
+        return 0;
+    }
+    return 1;
+}
+
+int openDiskLife(st_diskLife *board, const char *file) {
+    *board = {};
+    size_t size = 0;
+    void *data = mapFile(file, &size);
+    st_diskLifeHeader header = {};
+    if (data && size >= sizeof(header)) {
+        std::memcpy(&header, data, sizeof(header));
+    }
+    if (data) {
+        unmapFile(data, size);
+    }
+
+    const char *error = nullptr;
+    if (!data) {
+        error = "OPEN_FAILED";
+    } else if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC))) {
+        error = "NOT_A_BOARD";
+    } else if (header.version != DISK_LIFE_VERSION) {
+        error = "UNSUPPORTED_VERSION";
+    } else if (header.width <= 0 || header.height <= 0 || header.wordsPerRow != (header.width + 63) / 64 ||
+               header.boardSize < (uint64_t) (header.height + 2) * header.wordsPerRow * sizeof(uint64_t) ||
+               size < DISK_LIFE_ALIGNMENT + 2 * header.boardSize || header.rule[sizeof(header.rule) - 1] != '\0') {
+        error = "CORRUPT";
+    }
+    if (error) {
+        std::cout << "ERROR::DISK_LIFE::" << error << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+
+    if (!mapDiskLife(board, file, size) || !prepareDiskLife(board)) {
+        closeDiskLife(board);
+        return 0;
+    }
+    return 1;
+}
+
+void closeDiskLife(st_diskLife *board) {
+    if (board->mapping) {
+        unmapFile(board->mapping, board->mappingSize);
+    }
+    delete board->table;
+    board->mapping = nullptr;
+    board->header = nullptr;
+    board->table = nullptr;
+}
+
+void diskLifeView(const st_diskLife *board, st_lifeBoard *view) {
+    boardView(board, (int) (board->header->generation & 1), view);
+}
+
+void seedDiskLife(st_diskLife *board, uint64_t seed, double density, int threads) {
+    st_lifeBoard view;
+    diskLifeView(board, &view);
+    const uint32_t threshold = soupThreshold(density);
+    const uint64_t lastMask = view.width & 63 ? (1ull << (view.width & 63)) - 1 : ~0ull;
+    sweepDiskLife(board, -1, (int) (board->header->generation & 1), threads, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            uint64_t *row = lifeRow(&view, y);
+            for (int x = 0; x < view.wordsPerRow; ++x) {
+                row[x] = soupWord(seed, threshold, x, y);
+            }
+            row[view.wordsPerRow - 1] &= lastMask;
+        }
+    });
+}
+
+void stepDiskLife(st_diskLife *board, int generations, int threads) {
+    for (int i = 0; i < generations; ++i) {
+        const int current = (int) (board->header->generation & 1);
+        st_lifeBoard from, to;
+        boardView(board, current, &from);
+        boardView(board, current ^ 1, &to);
+        sweepDiskLife(board, current, current ^ 1, threads, [&](int begin, int end) {
+            if (board->rule.isotropic) {
+                stepIsotropicRange(&to, &from, board->table, begin, end);
+            } else {
+                stepLifeRange(&to, &from, &board->circuit, begin, end);
+            }
+        });
+        ++board->header->generation;
+    }
+}
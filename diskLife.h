@@ -0,0 +1,54 @@
+#ifndef CONWAY_LIFE_DISK_LIFE_H
+#define CONWAY_LIFE_DISK_LIFE_H
+
+#include "rule.h"
+#include "cpuLife.h"
+
+#include <cstdint>
+#include <cstddef>
+
+// Out-of-core board for boards larger than memory: a memory-mapped file holding a header page and two bit-packed
+// boards in the layout of st_lifeBoard, padding rows included, the current generation in board generation & 1.
+// Steps sweep the file from top to bottom in bands of about DISK_LIFE_BAND_BYTES, prefetching the band ahead,
+// writing back the band just stepped and dropping the bands behind, so only a few bands are ever resident.
+const uint32_t DISK_LIFE_VERSION = 1;
+const size_t DISK_LIFE_ALIGNMENT = 4096;
+const size_t DISK_LIFE_BAND_BYTES = 64 << 20;
+
+struct st_diskLifeHeader {
+    char magic[8];  // "CONWAYDL"
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t wordsPerRow;
+    int64_t generation;
+    uint64_t boardSize;  // bytes per board, DISK_LIFE_ALIGNMENT apart
+    char rule[128];
+};
+
+struct st_diskLife {
+    st_diskLifeHeader *header;  // in the mapping, generation is kept up to date there
+    st_rule rule;
+    st_ruleCircuit circuit;
+    st_isotropicTable *table;  // isotropic rules only
+    void *mapping;
+    size_t mappingSize;
+    int bandRows;
+};
+
+// Two-state rules only. The file is created sparse with every cell dead.
+int createDiskLife(st_diskLife *board, const char *file, int width, int height, const char *rule);
+
+int openDiskLife(st_diskLife *board, const char *file);
+
+void closeDiskLife(st_diskLife *board);
+
+// The current generation as a board in the mapping, for reading or setting a few cells
+void diskLifeView(const st_diskLife *board, st_lifeBoard *view);
+
+// Fills the current generation with the soup of seedLifeBoard, one band at a time
+void seedDiskLife(st_diskLife *board, uint64_t seed, double density, int threads);
+
+void stepDiskLife(st_diskLife *board, int generations, int threads);
+
+#endif
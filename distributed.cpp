@@ -0,0 +1,35 @@
+#include "distributedLife.h"
+
+#include <cstdint>
+#include <iostream>
+#include <chrono>
+
+// Steps one board split across WORKERS processes on this host, exchanging halo rows over Unix domain sockets every
+// HALO generations, and reports the population of the result.
+
+const int WIDTH = 1 << 14;
+const int HEIGHT = 1 << 14;
+const int TOPOLOGY = TOPOLOGY_FLAT;
+const char *RULE = "B3/S23";
+const uint64_t SEED = 1;
+const double DENSITY = 0.5;
+const long long GENERATIONS = 100;
+const int WORKERS = 8;
+const int HALO = 4;
+
+int main() {
+    st_distributedLife life;
+    if (!createDistributedLife(&life, WIDTH, HEIGHT, TOPOLOGY, RULE, WORKERS, HALO)) {
+        return -1;
+    }
+    long long population = 0;
+    auto begin = std::chrono::steady_clock::now();
+    if (!runDistributedLife(&life, SEED, DENSITY, GENERATIONS, &population, nullptr)) {
+        return -1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Generations: " << GENERATIONS << " on " << life.workers << " workers, halo " << life.halo << ", "
+              << (double) WIDTH * HEIGHT * GENERATIONS / seconds / 1e9 << " Gcells/s" << std::endl;
+    std::cout << "Population: " << population << std::endl;
+    return 0;
+}
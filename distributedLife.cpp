@@ -0,0 +1,398 @@
+#include "distributedLife.h"
+#include "cpuLife.h"
+#include "soup.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+static int stripBegin(const st_distributedLife *life, int worker) {
+    return (int) ((long long) worker * life->height / life->workers);
+}
+
+// rows [begin, end) whose far edge cells the ghost columns of worker need, clipped to the rows of owner
+static void mirrorRows(const st_distributedLife *life, int worker, int owner, int *begin, int *end) {
+    const int top = std::max(stripBegin(life, worker) - 1, 0);
+    const int bottom = std::min(stripBegin(life, worker + 1) + 1, life->height);
+    *begin = std::max(life->height - bottom, stripBegin(life, owner));
+    *end = std::min(life->height - top, stripBegin(life, owner + 1));
+}
+
+int createDistributedLife(st_distributedLife *life, int width, int height, int topology, const char *rule, int workers,
+                          int halo) {
+    *life = {};
+    st_rule parsed;
+    if (std::strlen(rule) >= sizeof(life->rule) || !parseRule(&parsed, rule)) {
+        std::cout << "ERROR::DISTRIBUTED_LIFE::UNSUPPORTED_RULE" << std::endl;
+        std::cout << rule << std::endl;
+        return 0;
+    }
+    life->width = width;
+    life->height = height;
+    life->topology = topology;
+    life->workers = std::clamp(workers, 1, height);
+    // halo rows come from the neighboring strip alone, and ghost columns only stay right for one generation
+    life->halo = topology == TOPOLOGY_MOBIUS ? 1 : std::clamp(halo, 1, height / life->workers);
+    std::strcpy(life->rule, rule);
+    return 1;
+}
+
+#ifdef _WIN32
+
+int runDistributedLife(const st_distributedLife *life, uint64_t seed, double density, long long generations,
+                       long long *population, unsigned char *cells) {
+    std::cout << "ERROR::DISTRIBUTED_LIFE::UNSUPPORTED_PLATFORM" << std::endl;
+    return 0;
+}
+
+#else
+
+struct st_transfer {
+    int fd;
+    const char *out;
+    size_t outSize;
+    char *in;
+    size_t inSize;
+};
+
+// Sends and receives on every socket at once, so that no pair of workers waits on each other with full buffers
+static int exchange(std::vector<st_transfer> &transfers) {
+    std::vector<pollfd> fds(transfers.size());
+    while (true) {
+        int pending = 0;
+        for (size_t i = 0; i < transfers.size(); ++i) {
+            fds[i] = {transfers[i].fd, (short) ((transfers[i].outSize ? POLLOUT : 0) |
+                                                (transfers[i].inSize ? POLLIN : 0)), 0};
+            pending += fds[i].events != 0;
+        }
+        if (!pending) {
+            return 1;
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < transfers.size(); ++i) {
+            st_transfer *transfer = &transfers[i];
+            // a worker gone away ends the run of its neighbors
+            if (transfer->outSize && fds[i].revents) {
+                ssize_t sent = send(transfer->fd, transfer->out, transfer->outSize, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    return 0;
+                }
+                transfer->out += std::max<ssize_t>(sent, 0);
+                transfer->outSize -= std::max<ssize_t>(sent, 0);
+            }
+            if (transfer->inSize && fds[i].revents) {
+                ssize_t received = recv(transfer->fd, transfer->in, transfer->inSize, MSG_DONTWAIT);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    return 0;
+                }
+                transfer->in += std::max<ssize_t>(received, 0);
+                transfer->inSize -= std::max<ssize_t>(received, 0);
+            }
+        }
+    }
+}
+
+static int writeAll(int fd, const void *data, size_t size) {
+    std::vector<st_transfer> transfers = {{fd, (const char *) data, size, nullptr, 0}};
+    return exchange(transfers);
+}
+
+static int readAll(int fd, void *data, size_t size) {
+    std::vector<st_transfer> transfers = {{fd, nullptr, 0, (char *) data, size}};
+    return exchange(transfers);
+}
+
+// The sockets of one worker, -1 where there is no peer
+struct st_workerLinks {
+    int above;
+    int below;
+    int result;
+    std::vector<int> mirrors;  // by owner of the mirrored rows, the worker itself included
+};
+
+struct st_worker {
+    const st_distributedLife *life;
+    int index;
+    int top;  // first row of the strip
+    int rows;
+    int haloAbove;
+    int haloBelow;
+    st_lifeBoard current;
+    st_lifeBoard next;
+    st_ruleCircuit circuit;
+    st_rule rule;
+    st_isotropicTable *table;
+};
+
+// local row of board row y, the ghost columns put board column x at local column x + 1
+static inline int localRow(const st_worker *worker, int y) {
+    return y - worker->top + worker->haloAbove;
+}
+
+static void seedStrip(st_worker *worker, uint64_t seed, double density) {
+    const int width = worker->life->width, words = (width + 63) / 64;
+    const uint32_t threshold = soupThreshold(density);
+    const uint64_t lastMask = width & 63 ? (1ull << (width & 63)) - 1 : ~0ull;
+    std::vector<uint64_t> soup(words + 1);
+    for (int y = worker->top; y < worker->top + worker->rows; ++y) {
+        for (int x = 0; x < words; ++x) {
+            soup[x] = soupWord(seed, threshold, x, y);
+        }
+        soup[words - 1] &= lastMask;
+        uint64_t *row = lifeRow(&worker->current, localRow(worker, y));
+        for (int x = 0; x < worker->current.wordsPerRow; ++x) {
+            row[x] = soup[x] << 1 | (x > 0 ? soup[x - 1] >> 63 : 0);
+        }
+    }
+}
+
+// Packs or unpacks count local rows from first of every plane
+static void copyRows(st_lifeBoard *board, int first, int count, uint64_t *buffer, bool pack) {
+    const size_t words = (size_t) count * board->wordsPerRow;
+    for (int p = 0; p < board->planes; ++p) {
+        uint64_t *rows = lifePlaneRow(board, p, first);
+        memcpy(pack ? buffer + p * words : rows, pack ? rows : buffer + p * words, words * sizeof(uint64_t));
+    }
+}
+
+// Refreshes the halo rows from the neighbors and, on Mobius boards, the far edges for the ghost columns
+static int exchangeEdges(st_worker *worker, const st_workerLinks *links, std::vector<unsigned char> *ghosts) {
+    const st_distributedLife *life = worker->life;
+    st_lifeBoard *board = &worker->current;
+    const size_t haloWords = (size_t) life->halo * board->planes * board->wordsPerRow;
+    std::vector<uint64_t> outAbove(haloWords), outBelow(haloWords), inAbove(haloWords), inBelow(haloWords);
+    std::vector<st_transfer> transfers;
+    if (links->above >= 0) {
+        copyRows(board, worker->haloAbove, life->halo, outAbove.data(), true);
+        transfers.push_back({links->above, (const char *) outAbove.data(), haloWords * sizeof(uint64_t),
+                             (char *) inAbove.data(), haloWords * sizeof(uint64_t)});
+    }
+    if (links->below >= 0) {
+        copyRows(board, worker->haloAbove + worker->rows - life->halo, life->halo, outBelow.data(), true);
+        transfers.push_back({links->below, (const char *) outBelow.data(), haloWords * sizeof(uint64_t),
+                             (char *) inBelow.data(), haloWords * sizeof(uint64_t)});
+    }
+
+    // two bytes per mirrored row, the states of its last and its first cell
+    std::vector<std::vector<unsigned char>> outMirror(life->workers), inMirror(life->workers);
+    for (int peer = 0; life->topology == TOPOLOGY_MOBIUS && peer < life->workers; ++peer) {
+        if (links->mirrors[peer] < 0 && peer != worker->index) {
+            continue;
+        }
+        int begin, end;
+        mirrorRows(life, peer, worker->index, &begin, &end);
+        for (int m = begin; m < end; ++m) {
+            outMirror[peer].push_back((unsigned char) getCell(board, life->width, localRow(worker, m)));
+            outMirror[peer].push_back((unsigned char) getCell(board, 1, localRow(worker, m)));
+        }
+        mirrorRows(life, worker->index, peer, &begin, &end);
+        inMirror[peer].resize(2 * (size_t) std::max(end - begin, 0));
+        if (peer == worker->index) {
+            inMirror[peer] = outMirror[peer];
+        } else {
+            transfers.push_back({links->mirrors[peer], (const char *) outMirror[peer].data(), outMirror[peer].size(),
+                                 (char *) inMirror[peer].data(), inMirror[peer].size()});
+        }
+    }
+
+    if (!exchange(transfers)) {
+        return 0;
+    }
+    if (links->above >= 0) {
+        copyRows(board, 0, life->halo, inAbove.data(), false);
+    }
+    if (links->below >= 0) {
+        copyRows(board, worker->haloAbove + worker->rows, life->halo, inBelow.data(), false);
+    }
+    for (int peer = 0; life->topology == TOPOLOGY_MOBIUS && peer < life->workers; ++peer) {
+        int begin, end;
+        mirrorRows(life, worker->index, peer, &begin, &end);
+        for (int m = begin; m < end; ++m) {
+            const int y = localRow(worker, life->height - 1 - m);
+            (*ghosts)[2 * y] = inMirror[peer][2 * (m - begin)];
+            (*ghosts)[2 * y + 1] = inMirror[peer][2 * (m - begin) + 1];
+        }
+    }
+    return 1;
+}
+
+static int runWorker(st_worker *worker, const st_workerLinks *links, uint64_t seed, double density,
+                     long long generations, bool gather) {
+    const st_distributedLife *life = worker->life;
+    const int height = worker->current.height, width = life->width;
+    // left and right ghost column per local row, dead unless a Mobius edge fills them in
+    std::vector<unsigned char> ghosts(2 * (size_t) height);
+    seedStrip(worker, seed, density);
+
+    for (long long generation = 0; generation < generations;) {
+        if (!exchangeEdges(worker, links, &ghosts)) {
+            std::cout << "ERROR::DISTRIBUTED_LIFE::EXCHANGE_FAILED" << std::endl;
+            return 0;
+        }
+        // every step the rows next to a halo edge go wrong, one more each time
+        const int steps = (int) std::min<long long>(life->halo, generations - generation);
+        for (int i = 0; i < steps; ++i, ++generation) {
+            for (int y = 0; y < height; ++y) {
+                setCell(&worker->current, 0, y, ghosts[2 * y]);
+                setCell(&worker->current, width + 1, y, ghosts[2 * y + 1]);
+            }
+            const int begin = worker->haloAbove ? i + 1 : 0, end = worker->haloBelow ? height - i - 1 : height;
+            if (worker->rule.isotropic) {
+                stepIsotropicRange(&worker->next, &worker->current, worker->table, begin, end);
+            } else {
+                stepLifeRange(&worker->next, &worker->current, &worker->circuit, begin, end);
+            }
+            std::swap(worker->current, worker->next);
+        }
+    }
+
+    long long population = 0;
+    std::vector<unsigned char> cells(gather ? (size_t) width * worker->rows : 0);
+    for (int y = 0; y < worker->rows; ++y) {
+        const int row = localRow(worker, worker->top + y);
+        setCell(&worker->current, 0, row, 0);
+        setCell(&worker->current, width + 1, row, 0);
+        for (int x = 0; x < worker->current.wordsPerRow; ++x) {
+            population += std::popcount(lifeRow(&worker->current, row)[x]);
+        }
+        for (int x = 0; gather && x < width; ++x) {
+            cells[(size_t) y * width + x] = (unsigned char) getCell(&worker->current, x + 1, row);
+        }
+    }
+    return writeAll(links->result, &population, sizeof(population)) &&
+           writeAll(links->result, cells.data(), cells.size());
+}
+
+static int startWorker(st_worker *worker, const st_distributedLife *life, int index) {
+    *worker = {};
+    worker->life = life;
+    worker->index = index;
+    worker->top = stripBegin(life, index);
+    worker->rows = stripBegin(life, index + 1) - worker->top;
+    worker->haloAbove = index > 0 ? life->halo : 0;
+    worker->haloBelow = index < life->workers - 1 ? life->halo : 0;
+    parseRule(&worker->rule, life->rule);
+    compileRule(&worker->circuit, &worker->rule);
+    if (worker->rule.isotropic) {
+        worker->table = new st_isotropicTable;
+        compileIsotropic(worker->table, &worker->rule);
+    }
+    const int height = worker->haloAbove + worker->rows + worker->haloBelow;
+    return createLifeBoard(&worker->current, life->width + 2, height, worker->rule.states) &&
+           createLifeBoard(&worker->next, life->width + 2, height, worker->rule.states);
+}
+
+static void stopWorker(st_worker *worker) {
+    destroyLifeBoard(&worker->current);
+    destroyLifeBoard(&worker->next);
+    delete worker->table;
+}
+
+int runDistributedLife(const st_distributedLife *life, uint64_t seed, double density, long long generations,
+                       long long *population, unsigned char *cells) {
+    const int workers = life->workers;
+    std::vector<st_workerLinks> links(workers, {-1, -1, -1, std::vector<int>(workers, -1)});
+    std::vector<int> parentEnds(workers, -1), sockets;
+    auto link = [&](int *a, int *b) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            return false;
+        }
+        *a = pair[0];
+        *b = pair[1];
+        sockets.insert(sockets.end(), pair, pair + 2);
+        return true;
+    };
+
+    bool linked = true;
+    for (int w = 0; w < workers; ++w) {
+        linked = linked && link(&links[w].result, &parentEnds[w]);
+        if (w > 0) {
+            linked = linked && link(&links[w].above, &links[w - 1].below);
+        }
+        for (int peer = 0; life->topology == TOPOLOGY_MOBIUS && peer < w; ++peer) {
+            int begin, end, mirroredBegin, mirroredEnd;
+            mirrorRows(life, w, peer, &begin, &end);
+            mirrorRows(life, peer, w, &mirroredBegin, &mirroredEnd);
+            if (begin < end || mirroredBegin < mirroredEnd) {
+                linked = linked && link(&links[w].mirrors[peer], &links[peer].mirrors[w]);
+            }
+        }
+    }
+    if (!linked) {
+        std::cout << "ERROR::DISTRIBUTED_LIFE::SOCKET_FAILED" << std::endl;
+        for (int fd : sockets) {
+            close(fd);
+        }
+        return 0;
+    }
+
+    std::cout.flush();
+    std::vector<pid_t> pids;
+    for (int w = 0; w < workers; ++w) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // only the sockets of this worker stay open, so that a worker that dies is seen by its peers
+            std::vector<int> own = {links[w].above, links[w].below, links[w].result};
+            own.insert(own.end(), links[w].mirrors.begin(), links[w].mirrors.end());
+            for (int fd : sockets) {
+                if (std::find(own.begin(), own.end(), fd) == own.end()) {
+                    close(fd);
+                }
+            }
+            st_worker worker;
+            int success = startWorker(&worker, life, w) &&
+                          runWorker(&worker, &links[w], seed, density, generations, cells != nullptr);
+            stopWorker(&worker);
+            std::cout.flush();
+            _exit(success ? 0 : 1);
+        }
+        if (pid < 0) {
+            std::cout << "ERROR::DISTRIBUTED_LIFE::FORK_FAILED" << std::endl;
+            break;
+        }
+        pids.push_back(pid);
+    }
+    for (int fd : sockets) {
+        if (std::find(parentEnds.begin(), parentEnds.end(), fd) == parentEnds.end()) {
+            close(fd);
+        }
+    }
+
+    // results come back strip by strip
+    int success = (int) pids.size() == workers;
+    *population = 0;
+    for (int w = 0; w < (int) pids.size() && success; ++w) {
+        long long strip = 0;
+        const int top = stripBegin(life, w), rows = stripBegin(life, w + 1) - top;
+        success = readAll(parentEnds[w], &strip, sizeof(strip)) &&
+                  (!cells || readAll(parentEnds[w], cells + (size_t) top * life->width, (size_t) rows * life->width));
+        *population += strip;
+    }
+    for (int fd : parentEnds) {
+        close(fd);
+    }
+    for (pid_t pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    if (!success) {
+        std::cout << "ERROR::DISTRIBUTED_LIFE::WORKER_FAILED" << std::endl;
+    }
+    return success;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CONWAY_LIFE_DISTRIBUTED_LIFE_H
+#define CONWAY_LIFE_DISTRIBUTED_LIFE_H
+
+#include "rule.h"
+#include "checkpoint.h"
+
+#include <cstdint>
+
+// Board split into horizontal strips, one per worker process, each stepped on the CPU kernels. A strip is padded with
+// halo rows from the strips above and below it, halo deep, so a worker steps halo generations between exchanges while
+// the rows it gets wrong grow in from the halo edges. Each strip also carries a ghost column on either side, dead on
+// flat boards; on Mobius boards it holds the far edge of the mirrored strip, sent by its worker every generation.
+// Workers talk over Unix domain sockets, one per pair of neighbors, so workers on several hosts only need a stream
+// socket in their place. The top and bottom strips have no halo beyond the board and see the dead padding rows.
+struct st_distributedLife {
+    int width;
+    int height;
+    int topology;  // TOPOLOGY_ from checkpoint.h
+    int workers;
+    int halo;  // generations between exchanges, 1 on Mobius boards
+    char rule[128];
+};
+
+// Not for Larger than Life rules. Lowers halo to what the smallest strip and the topology allow.
+int createDistributedLife(st_distributedLife *life, int width, int height, int topology, const char *rule, int workers,
+                          int halo);
+
+// Seeds the board with the soup of seedLifeBoard, runs generations and collects the population of the result and,
+// unless cells is null, the board itself, one byte of state per cell and width bytes per row
+int runDistributedLife(const st_distributedLife *life, uint64_t seed, double density, long long generations,
+                       long long *population, unsigned char *cells);
+
+#endif
@@ -0,0 +1,339 @@
+#include "frameExport.h"
+#include "parallel.h"
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+
+// PNG: zlib stream with a single fixed Huffman deflate block and greedy LZ77 matching. Rendered boards are mostly
+// long runs of identical pixels, which this compresses well at a fraction of the cost of a full deflate.
+
+static uint32_t crcTable[256];
+
+static void initCrc() {
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        }
+        crcTable[n] = c;
+    }
+}
+
+static uint32_t crc32(uint32_t crc, const unsigned char *data, size_t size) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t adler32(const unsigned char *data, size_t size) {
+    uint32_t a = 1, b = 0;
+    while (size) {
+        // largest block before the sums can overflow
+        size_t block = size < 5552 ? size : 5552;
+        for (size_t i = 0; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += block;
+        size -= block;
+    }
+    return b << 16 | a;
+}
+
+struct st_bitWriter {
+    std::vector<unsigned char> *out;
+    uint64_t bits;
+    int count;
+};
+
+static void putBits(st_bitWriter *w, uint32_t value, int count) {
+    w->bits |= (uint64_t) value << w->count;
+    w->count += count;
+    while (w->count >= 8) {
+        w->out->push_back((unsigned char) w->bits);
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+// Huffman codes go out most significant bit first
+static void putCode(st_bitWriter *w, uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+    }
+    putBits(w, reversed, length);
+}
+
+static void putLiteral(st_bitWriter *w, int symbol) {
+    if (symbol < 144) {
+        putCode(w, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        putCode(w, 0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        putCode(w, symbol - 256, 7);
+    } else {
+        putCode(w, 0xc0 + symbol - 280, 8);
+    }
+}
+
+static const int LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83,
+                                    99, 115, 131, 163, 195, 227, 258};
+static const int LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5,
+                                     5, 0};
+static const int DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const int DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11,
+                                       11, 12, 12, 13, 13};
+
+static void putMatch(st_bitWriter *w, int length, int distance) {
+    int l = 28;
+    while (LENGTH_BASE[l] > length) {
+        --l;
+    }
+    putLiteral(w, 257 + l);
+    putBits(w, length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+    int d = 29;
+    while (DISTANCE_BASE[d] > distance) {
+        --d;
+    }
+    putCode(w, d, 5);
+    putBits(w, distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+}
+
+static void deflate(std::vector<unsigned char> *out, const unsigned char *data, size_t size) {
+    const int HASH_BITS = 15, WINDOW = 32768, MAX_MATCH = 258;
+    std::vector<int64_t> head(1 << HASH_BITS, -1);
+    st_bitWriter w = {out, 0, 0};
+    out->push_back(0x78);
+    out->push_back(0x01);
+    putBits(&w, 1, 1);  // final block
+    putBits(&w, 1, 2);  // fixed Huffman codes
+
+    size_t i = 0;
+    while (i < size) {
+        int length = 0;
+        size_t candidate = 0;
+        if (i + 3 <= size) {
+            uint32_t hash = (data[i] | data[i + 1] << 8 | data[i + 2] << 16) * 2654435761u >> (32 - HASH_BITS);
+            int64_t last = head[hash];
+            head[hash] = (int64_t) i;
+            if (last >= 0 && i - last <= WINDOW) {
+                candidate = (size_t) last;
+                size_t limit = size - i < MAX_MATCH ? size - i : MAX_MATCH;
+                while ((size_t) length < limit && data[candidate + length] == data[i + length]) {
+                    ++length;
+                }
+            }
+        }
+        if (length >= 3) {
+            putMatch(&w, length, (int) (i - candidate));
+            i += length;
+        } else {
+            putLiteral(&w, data[i++]);
+        }
+    }
+    putLiteral(&w, 256);
+    if (w.count) {
+        putBits(&w, 0, 8 - w.count);
+    }
+    uint32_t adler = adler32(data, size);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out->push_back((unsigned char) (adler >> shift));
+    }
+}
+
+static void putChunk(std::vector<unsigned char> *png, const char *type, const unsigned char *data, size_t size) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        png->push_back((unsigned char) (size >> shift));
+    }
+    size_t start = png->size();
+    png->insert(png->end(), type, type + 4);
+    png->insert(png->end(), data, data + size);
+    uint32_t crc = crc32(0, png->data() + start, size + 4);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        png->push_back((unsigned char) (crc >> shift));
+    }
+}
+
+static int writePng(const char *file, const unsigned char *rgba, int width, int height) {
+    // RGB rows top first, each behind a filter byte of 0
+    std::vector<unsigned char> raw((size_t) (width * 3 + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        unsigned char *row = raw.data() + (size_t) (width * 3 + 1) * y;
+        const unsigned char *in = rgba + (size_t) width * 4 * (height - 1 - y);
+        *row++ = 0;
+        for (int x = 0; x < width; ++x) {
+            *row++ = in[4 * x];
+            *row++ = in[4 * x + 1];
+            *row++ = in[4 * x + 2];
+        }
+    }
+    std::vector<unsigned char> compressed;
+    deflate(&compressed, raw.data(), raw.size());
+
+    std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    unsigned char header[13] = {(unsigned char) (width >> 24), (unsigned char) (width >> 16),
+                                (unsigned char) (width >> 8), (unsigned char) width, (unsigned char) (height >> 24),
+                                (unsigned char) (height >> 16), (unsigned char) (height >> 8), (unsigned char) height,
+                                8, 2, 0, 0, 0};
+    putChunk(&png, "IHDR", header, sizeof(header));
+    putChunk(&png, "IDAT", compressed.data(), compressed.size());
+    putChunk(&png, "IEND", nullptr, 0);
+
+    FILE *f = fopen(file, "wb");
+    int success = f && fwrite(png.data(), png.size(), 1, f) == 1;
+    if (f) {
+        success = fclose(f) == 0 && success;
+    }
+    return success;
+}
+
+// full range BT.601, chroma averaged over 2x2 blocks
+static void toYuv420(unsigned char *yuv, const unsigned char *rgba, int width, int height) {
+    const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    unsigned char *u = yuv + (size_t) width * height, *v = u + (size_t) chromaWidth * chromaHeight;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char *in = rgba + (size_t) width * 4 * (height - 1 - y);
+        for (int x = 0; x < width; ++x) {
+            yuv[(size_t) y * width + x] = (unsigned char) ((77 * in[4 * x] + 150 * in[4 * x + 1] + 29 * in[4 * x + 2]
+                                                            + 128) >> 8);
+        }
+    }
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            int r = 0, g = 0, b = 0, n = 0;
+            for (int y = 2 * cy; y < 2 * cy + 2 && y < height; ++y) {
+                const unsigned char *in = rgba + (size_t) width * 4 * (height - 1 - y);
+                for (int x = 2 * cx; x < 2 * cx + 2 && x < width; ++x, ++n) {
+                    r += in[4 * x];
+                    g += in[4 * x + 1];
+                    b += in[4 * x + 2];
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            u[(size_t) cy * chromaWidth + cx] = (unsigned char) ((-43 * r - 85 * g + 128 * b + 32768 + 128) >> 8);
+            v[(size_t) cy * chromaWidth + cx] = (unsigned char) ((128 * r - 107 * g - 21 * b + 32768 + 128) >> 8);
+        }
+    }
+}
+
+static void encodeFrames(st_frameEncoder *encoder) {
+    const size_t yuvSize = (size_t) encoder->width * encoder->height +
+                           2 * (size_t) ((encoder->width + 1) / 2) * ((encoder->height + 1) / 2);
+    std::vector<unsigned char> yuv(encoder->y4m ? yuvSize : 0);
+    std::vector<char> name(encoder->path.size() + 32);
+    for (;;) {
+        std::unique_lock<std::mutex> lock(encoder->mutex);
+        encoder->changed.wait(lock, [encoder] { return encoder->closing || !encoder->ready.empty(); });
+        if (encoder->ready.empty()) {
+            return;
+        }
+        auto [buffer, number] = encoder->ready.front();
+        encoder->ready.pop_front();
+        lock.unlock();
+
+        const unsigned char *rgba = encoder->frames[buffer].data();
+        bool success;
+        if (encoder->y4m) {
+            toYuv420(yuv.data(), rgba, encoder->width, encoder->height);
+            lock.lock();
+            // append in order, later frames wait for their turn
+            encoder->changed.wait(lock, [encoder, number] { return encoder->written == number; });
+            success = fputs("FRAME\n", encoder->file) != EOF && fwrite(yuv.data(), yuvSize, 1, encoder->file) == 1;
+            ++encoder->written;
+        } else {
+            std::snprintf(name.data(), name.size(), encoder->path.c_str(), (int) number);
+            success = writePng(name.data(), rgba, encoder->width, encoder->height);
+            lock.lock();
+        }
+        if (!success && !encoder->failed) {
+            std::cout << "ERROR::FRAME_EXPORT::WRITE_FAILED" << std::endl;
+        }
+        encoder->failed = encoder->failed || !success;
+        encoder->free.push_back(buffer);
+        encoder->changed.notify_all();
+    }
+}
+
+int openFrameEncoder(st_frameEncoder *encoder, const char *path, int width, int height, int fps, int threads) {
+    static std::once_flag crcReady;
+    std::call_once(crcReady, initCrc);
+
+    const char *extension = std::strrchr(path, '.');
+    encoder->y4m = extension && std::strcmp(extension, ".y4m") == 0;
+    encoder->width = width;
+    encoder->height = height;
+    encoder->path = path;
+    encoder->file = nullptr;
+    if (encoder->y4m) {
+        encoder->file = fopen(path, "wb");
+        if (!encoder->file || fprintf(encoder->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height,
+                                      fps) < 0) {
+            std::cout << "ERROR::FRAME_EXPORT::OPEN_FAILED" << std::endl;
+            std::cout << path << std::endl;
+            if (encoder->file) {
+                fclose(encoder->file);
+            }
+            return 0;
+        }
+    }
+
+    encoder->frames.assign(ENCODER_QUEUE, std::vector<unsigned char>((size_t) width * height * 4));
+    encoder->free.clear();
+    encoder->ready.clear();
+    for (int i = 0; i < ENCODER_QUEUE; ++i) {
+        encoder->free.push_back(i);
+    }
+    encoder->submitted = encoder->written = 0;
+    encoder->closing = encoder->failed = false;
+    if (threads <= 0) {
+        threads = hardwareThreads();
+    }
+    encoder->workers.clear();
+    for (int i = 0; i < threads; ++i) {
+        encoder->workers.emplace_back(encodeFrames, encoder);
+    }
+    return 1;
+}
+
+int encodeFrame(st_frameEncoder *encoder, const unsigned char *rgba) {
+    std::unique_lock<std::mutex> lock(encoder->mutex);
+    encoder->changed.wait(lock, [encoder] { return !encoder->free.empty(); });
+    int buffer = encoder->free.front();
+    encoder->free.pop_front();
+    lock.unlock();
+
+    std::memcpy(encoder->frames[buffer].data(), rgba, encoder->frames[buffer].size());
+
+    lock.lock();
+    encoder->ready.emplace_back(buffer, encoder->submitted++);
+    encoder->changed.notify_all();
+    return !encoder->failed;
+}
+
+int closeFrameEncoder(st_frameEncoder *encoder) {
+    {
+        std::lock_guard<std::mutex> lock(encoder->mutex);
+        encoder->closing = true;
+        encoder->changed.notify_all();
+    }
+    for (auto &worker: encoder->workers) {
+        worker.join();
+    }
+    encoder->workers.clear();
+    int success = !encoder->failed;
+    if (encoder->file) {
+        success = fclose(encoder->file) == 0 && success;
+        encoder->file = nullptr;
+    }
+    encoder->frames.clear();
+    return success;
+}
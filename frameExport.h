@@ -0,0 +1,44 @@
+#ifndef CONWAY_LIFE_FRAME_EXPORT_H
+#define CONWAY_LIFE_FRAME_EXPORT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Pool of encoder threads turning rendered RGBA frames (bottom row first, as glReadPixels returns them) into a Y4M
+// video or a numbered PNG sequence. The file name picks the format: "run.y4m" writes one 4:2:0 stream, anything
+// else is a printf pattern such as "frames/%06d.png". PNG frames go to their own files in any order; Y4M frames are
+// converted in parallel and appended in submission order.
+const int ENCODER_QUEUE = 16;  // frames buffered for the encoders, encodeFrame blocks beyond that
+
+struct st_frameEncoder {
+    bool y4m;
+    int width;
+    int height;
+    std::string path;
+    FILE *file;
+    std::vector<std::vector<unsigned char>> frames;
+    std::deque<int> free;
+    std::deque<std::pair<int, long long>> ready;  // buffer and frame number
+    long long submitted;
+    long long written;  // Y4M frames appended so far
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool closing;
+    bool failed;
+};
+
+// threads <= 0 uses every hardware thread
+int openFrameEncoder(st_frameEncoder *encoder, const char *path, int width, int height, int fps, int threads);
+
+// Copies the frame into the queue
+int encodeFrame(st_frameEncoder *encoder, const unsigned char *rgba);
+
+int closeFrameEncoder(st_frameEncoder *encoder);
+
+#endif
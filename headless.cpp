@@ -0,0 +1,179 @@
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "conway.h"
+#include "cpuLife.h"
+#include "soup.h"
+#include "ltlLife.h"
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+// Runs the compute shaders without a window, on a surfaceless EGL context. Works on servers without a display and
+// under Mesa llvmpipe in CI. With VERIFY set the same run is repeated on the CPU engines and the boards compared,
+// the exit code tells whether they matched.
+
+const int BOARD_HEIGHT = 512;
+const int BOARD_WIDTH = BOARD_HEIGHT;
+
+const char *RULE = "B3/S23";  // or a Larger than Life rule, e.g. "R5,C2,M1,S33..57,B34..45,NM"
+const int GENERATIONS = 100;
+const uint64_t SEED = 1;
+const double DENSITY = .5;
+const bool VERIFY = true;
+
+int createHeadlessContext(EGLDisplay *display, EGLContext *context) {
+    // the surfaceless platform needs neither a display server nor a render node
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    *display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                                  : EGL_NO_DISPLAY;
+    if (*display == EGL_NO_DISPLAY) {
+        *display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint major, minor;
+    if (*display == EGL_NO_DISPLAY || !eglInitialize(*display, &major, &minor)) {
+        std::cout << "ERROR::EGL::INITIALIZATION_FAILED" << std::endl;
+        return 0;
+    }
+    std::cout << "EGLVersion: " << major << "." << minor << std::endl;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "ERROR::EGL::OPENGL_UNSUPPORTED" << std::endl;
+        return 0;
+    }
+    const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(*display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        config = EGL_NO_CONFIG_KHR;
+    }
+    const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 4,
+                                        EGL_CONTEXT_MINOR_VERSION, 4,
+                                        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                        EGL_NONE};
+    *context = eglCreateContext(*display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (*context == EGL_NO_CONTEXT || !eglMakeCurrent(*display, EGL_NO_SURFACE, EGL_NO_SURFACE, *context)) {
+        std::cout << "ERROR::EGL::CONTEXT_CREATION_FAILED" << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+// Same run on the CPU engines, seeded on the CPU too, compared cell by cell and, but for Larger than Life, against the
+// statistics of the last step
+bool verifyOnCpu(const st_conway *engine, const unsigned char *start, const unsigned char *end,
+                 const st_conwayStats *stats) {
+    std::vector<unsigned char> soup(BOARD_WIDTH * BOARD_HEIGHT);
+    seedCells(soup.data(), BOARD_WIDTH, BOARD_WIDTH, BOARD_HEIGHT, SEED, DENSITY, 0);
+    int seedMismatches = 0;
+    for (int i = 0; i < BOARD_WIDTH * BOARD_HEIGHT; ++i) {
+        seedMismatches += soup[i] != start[i];
+    }
+    std::cout << "Mismatched seed cells: " << seedMismatches << std::endl;
+
+    int mismatches = 0;
+    bool statsMatch = true;
+    if (engine->ltl) {
+        st_ltlBoard current, next;
+        createLtlBoard(&current, BOARD_WIDTH, BOARD_HEIGHT);
+        createLtlBoard(&next, BOARD_WIDTH, BOARD_HEIGHT);
+        seedCells(current.cells, BOARD_WIDTH, BOARD_WIDTH, BOARD_HEIGHT, SEED, DENSITY, 0);
+        for (int i = 0; i < GENERATIONS; ++i) {
+            stepLtl(&next, &current, &engine->ltlRule, 0);
+            std::swap(current, next);
+        }
+        for (int y = 0; y < BOARD_HEIGHT; ++y) {
+            for (int x = 0; x < BOARD_WIDTH; ++x) {
+                mismatches += getLtlCell(&current, x, y) != end[x + y * BOARD_WIDTH];
+            }
+        }
+        destroyLtlBoard(&current);
+        destroyLtlBoard(&next);
+    } else {
+        const st_rule *rule = &engine->rule;
+        st_lifeBoard current, next;
+        createLifeBoard(&current, BOARD_WIDTH, BOARD_HEIGHT, rule->states);
+        createLifeBoard(&next, BOARD_WIDTH, BOARD_HEIGHT, rule->states);
+        seedLifeBoard(&current, SEED, DENSITY, 0);
+        st_ruleCircuit circuit;
+        auto *table = new st_isotropicTable;
+        compileRule(&circuit, rule);
+        compileIsotropic(table, rule);
+        st_lifeStats cpuStats = {};
+        for (int i = 0; i < GENERATIONS; ++i) {
+            if (rule->isotropic) {
+                stepIsotropic(&next, &current, table, 0, &cpuStats);
+            } else {
+                stepLife(&next, &current, &circuit, 0, &cpuStats);
+            }
+            std::swap(current, next);
+        }
+        statsMatch = cpuStats.population == stats->population && cpuStats.births == stats->births &&
+                     cpuStats.deaths == stats->deaths &&
+                     std::equal(cpuStats.bounds, cpuStats.bounds + 4, stats->bounds);
+        std::cout << "Statistics match: " << (statsMatch ? "yes" : "no") << std::endl;
+        for (int y = 0; y < BOARD_HEIGHT; ++y) {
+            for (int x = 0; x < BOARD_WIDTH; ++x) {
+                mismatches += getCell(&current, x, y) != end[x + y * BOARD_WIDTH];
+            }
+        }
+        delete table;
+        destroyLifeBoard(&current);
+        destroyLifeBoard(&next);
+    }
+    std::cout << "Mismatched cells: " << mismatches << std::endl;
+    return seedMismatches == 0 && mismatches == 0 && statsMatch;
+}
+
+int main() {
+    EGLDisplay display;
+    EGLContext context;
+    if (!createHeadlessContext(&display, &context)) {
+        return -1;
+    }
+    if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    std::cout << "GLVersion: " << GLVersion.major << "." << GLVersion.minor << std::endl;
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+    int result = -1;
+    st_conway engine;
+    if (conwayCreate(&engine, BOARD_WIDTH, BOARD_HEIGHT, TOPOLOGY_FLAT, RULE)) {
+        std::vector<unsigned char> start(BOARD_WIDTH * BOARD_HEIGHT), end(BOARD_WIDTH * BOARD_HEIGHT);
+        conwaySeed(&engine, SEED, DENSITY);
+        conwayExport(&engine, start.data(), BOARD_WIDTH);
+
+        auto begin = std::chrono::steady_clock::now();
+        conwayStep(&engine, GENERATIONS);
+        glFinish();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Generations: " << GENERATIONS << " in " << seconds << " s, "
+                  << GENERATIONS / seconds << " generations/s, "
+                  << (double) BOARD_WIDTH * BOARD_HEIGHT * GENERATIONS / seconds / 1e9 << " Gcells/s" << std::endl;
+
+        st_conwayStats stats;
+        conwayQuery(&engine, &stats);
+        std::cout << "Population: " << stats.population << ", births: " << stats.births << ", deaths: "
+                  << stats.deaths << ", bounds: [" << stats.bounds[0] << ", " << stats.bounds[2] << ") x ["
+                  << stats.bounds[1] << ", " << stats.bounds[3] << ")" << std::endl;
+        int period = conwayQueryPeriod(&engine);
+        if (period) {
+            std::cout << "Stable with period " << period << std::endl;
+        }
+
+        conwayExport(&engine, end.data(), BOARD_WIDTH);
+        result = !VERIFY || verifyOnCpu(&engine, start.data(), end.data(), &stats) ? 0 : 1;
+    }
+    conwayDestroy(&engine);
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+
+    return result;
+}
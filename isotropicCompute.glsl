@@ -0,0 +1,79 @@
+#version 430 core
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) buffer Params {
+    int boardWidth;
+    int boardHeight;
+    int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
+    uint ruleTable[16];  // next state of every 3x3 neighborhood, bit 4 is the center
+};
+
+layout(std430, binding = 1) buffer CurrentBoard {
+    uint currentBoard[];
+};
+
+layout(std430, binding = 2) buffer OldBoard {
+    uint oldBoard[];
+};
+
+// statsCompute.glsl
+void statsWord(int word, int x, int y, uint cells, uint old);
+void statsFlush();
+
+shared uint sharedTable[16];
+
+// bit b set when byte b of word is a live cell
+uint aliveBits(uint word) {
+    bvec4 alive = equal((uvec4(word) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu, uvec4(1u));
+    return (alive.x ? 1u : 0u) | (alive.y ? 2u : 0u) | (alive.z ? 4u : 0u) | (alive.w ? 8u : 0u);
+}
+
+// live cells x - 1 .. x + 4 of a row as bits 0 .. 5, x the first cell of the word. Past either end of the row they
+// read as dead, only padding cells would look at them.
+uint rowWindow(int word, int column) {
+    uint left = column > 0 ? aliveBits(oldBoard[word - 1]) >> 3 : 0u;
+    uint right = column + 1 < boardStride / 4 ? aliveBits(oldBoard[word + 1]) & 1u : 0u;
+    return left | aliveBits(oldBoard[word]) << 1 | right << 5;
+}
+
+void main() {
+    // the table is looked up once per cell, from shared memory rather than the params buffer
+    if (gl_LocalInvocationIndex < 16u) {
+        sharedTable[gl_LocalInvocationIndex] = ruleTable[gl_LocalInvocationIndex];
+    }
+    barrier();
+
+    // one invocation per word, those past the end of the row only take part in the reduction. There can be more rows
+    // than workgroups along y, each workgroup steps down by their count.
+    int column = int(gl_GlobalInvocationID.x);
+    for (int y = int(gl_WorkGroupID.y); y < boardHeight && column < boardStride / 4; y += int(gl_NumWorkGroups.y)) {
+        int word = column + (y + 1) * (boardStride / 4);
+        // each row of the three is read once, three words wide, instead of nine bytes per cell
+        uint above = rowWindow(word - boardStride / 4, column), middle = rowWindow(word, column);
+        uint below = rowWindow(word + boardStride / 4, column), middleWord = oldBoard[word];
+        uint next = 0u, cells = 0u, old = 0u;
+        for (int b = 0; b < 4; ++b) {
+            int x = column * 4 + b;
+            uint state = (middleWord >> (b * 8)) & 0xFFu;
+            if (x >= 1 && x <= boardWidth) {
+                old |= state << (b * 8);
+                uint neighborhood = (above >> b & 7u) | (middle >> b & 7u) << 3 | (below >> b & 7u) << 6;
+                bool alive = ((sharedTable[neighborhood >> 5] >> (neighborhood & 31u)) & 1u) != 0u;
+                if (state == 0u) {
+                    state = alive ? 1u : 0u;
+                } else if (state != 1u || !alive) {
+                    state = (state + 1u) % uint(states);
+                }
+                cells |= state << (b * 8);
+            }
+            next |= state << (b * 8);
+        }
+        currentBoard[word] = next;
+        statsWord(word, column * 4 - 1, y, cells, old);
+    }
+    statsFlush();
+}
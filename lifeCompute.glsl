@@ -1,40 +1,82 @@
 #version 430 core
-layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
 
 layout(std430, binding = 0) buffer Params {
     int boardWidth;
     int boardHeight;
     int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
+    uint ruleTable[16];
+    int range;
+    int middle;
+    int birthMin;
+    int birthMax;
+    int surviveMin;
+    int surviveMax;
+    int neighborWeights[8];
 };
 
+// compiled once per neighborhood, the host prepends the matching define
+#if defined(NEIGHBORHOOD_HEXAGONAL)
+const int NEIGHBORS[6] = int[6](0, 1, 3, 4, 6, 7);  // no BOTTOM RIGHT and UPPER LEFT
+#elif defined(NEIGHBORHOOD_VON_NEUMANN)
+const int NEIGHBORS[4] = int[4](1, 3, 4, 6);
+#else
+const int NEIGHBORS[8] = int[8](0, 1, 2, 3, 4, 5, 6, 7);
+#endif
+
+// one byte of state per cell, four cells per word
 layout(std430, binding = 1) buffer CurrentBoard {
-    float currentBoard[];
+    uint currentBoard[];
 };
 
 layout(std430, binding = 2) buffer OldBoard {
-    float oldBoard[];
+    uint oldBoard[];
 };
 
+// statsCompute.glsl
+void statsWord(int word, int x, int y, uint cells, uint old);
+void statsFlush();
+
+uint oldState(int index) {
+    return (oldBoard[index >> 2] >> ((index & 3) * 8)) & 0xFFu;
+}
+
 void main() {
-    float fadeConst = 0.5;  // place this in a buffer/uniform
-    uint index = gl_WorkGroupID.x + 1 + (gl_WorkGroupID.y + 1) * (boardWidth + 2);
-    int sum = 0;
-    for (int k = 0; k < 8; ++k) {
-        sum += oldBoard[index + neighborIndices[k]] == 1.0 ? 1 : 0;
-    }
-    if (oldBoard[index] == 1.0) {
-        if (sum < 2 || sum >= 4) {
-            // board[index] = .0f;
-            currentBoard[index] = oldBoard[index] * fadeConst;
-        } else {
-            currentBoard[index] = 1.0;
-        }
-    } else {
-        if (sum == 3) {
-            currentBoard[index] = 1.0;
-        } else {
-            // board[index] = .0f;
-            currentBoard[index] = oldBoard[index] * fadeConst;
+    // one invocation per word, those past the end of the row only take part in the reduction. There can be more rows
+    // than workgroups along y, each workgroup steps down by their count.
+    int column = int(gl_GlobalInvocationID.x);
+    for (int y = int(gl_WorkGroupID.y); y < boardHeight && column < boardStride / 4; y += int(gl_NumWorkGroups.y)) {
+        int word = column + (y + 1) * (boardStride / 4);
+        uint next = 0u, cells = 0u, old = 0u;
+        for (int b = 0; b < 4; ++b) {
+            int x = column * 4 + b;
+            int index = word * 4 + b;
+            uint state = oldState(index);
+            if (x >= 1 && x <= boardWidth) {
+                int sum = 0;
+                for (int k = 0; k < NEIGHBORS.length(); ++k) {
+#if defined(NEIGHBORHOOD_WEIGHTED)
+                    sum += oldState(index + neighborIndices[NEIGHBORS[k]]) == 1u ? neighborWeights[NEIGHBORS[k]] : 0;
+#else
+                    sum += oldState(index + neighborIndices[NEIGHBORS[k]]) == 1u ? 1 : 0;
+#endif
+                }
+                old |= state << (b * 8);
+                if (state == 0u) {
+                    state = ((birth >> sum) & 1) != 0 ? 1u : 0u;
+                } else if (state != 1u || ((survive >> sum) & 1) == 0) {
+                    state = (state + 1u) % uint(states);
+                }
+                cells |= state << (b * 8);
+            }
+            next |= state << (b * 8);
         }
+        currentBoard[word] = next;
+        statsWord(word, column * 4 - 1, y, cells, old);
     }
+    statsFlush();
 }
@@ -0,0 +1,88 @@
+#version 430 core
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) buffer Params {
+    int boardWidth;
+    int boardHeight;
+    int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
+    uint ruleTable[16];
+    int range;
+    int middle;
+    int birthMin;
+    int birthMax;
+    int surviveMin;
+    int surviveMax;
+};
+
+layout(std430, binding = 1) buffer CurrentBoard {
+    uint currentBoard[];
+};
+
+layout(std430, binding = 2) buffer OldBoard {
+    uint oldBoard[];
+};
+
+layout(std430, binding = 3) buffer RowSums {
+    uint rowSums[];
+};
+
+// statsCompute.glsl
+void statsWord(int word, int x, int y, uint cells, uint old);
+void statsFlush();
+
+const int SPAN = 64;  // rows per invocation
+
+// slides the box sums of one board word (four columns) down a band of rows, invocations past the end of the row only
+// take part in the reduction
+void main() {
+    int stride = boardStride / 4, column = int(gl_GlobalInvocationID.x);
+    if (column < stride) {
+        int begin = int(gl_WorkGroupID.y) * SPAN;
+        int end = min(begin + SPAN, boardHeight);
+
+        int sums[4];
+        for (int b = 0; b < 4; ++b) {
+            int x = column * 4 + b - 1;
+            sums[b] = 0;
+            if (x >= 0 && x < boardWidth) {
+                for (int y = max(begin - range, 0); y < min(begin + range, boardHeight); ++y) {
+                    sums[b] += int(rowSums[x + y * boardWidth]);
+                }
+            }
+        }
+
+        for (int y = begin; y < end; ++y) {
+            int word = column + (y + 1) * stride;
+            uint old = oldBoard[word];
+            uint next = 0u, cells = 0u, before = 0u;
+            for (int b = 0; b < 4; ++b) {
+                int x = column * 4 + b - 1;
+                uint state = (old >> (b * 8)) & 0xFFu;
+                if (x >= 0 && x < boardWidth) {
+                    if (y + range < boardHeight) {
+                        sums[b] += int(rowSums[x + (y + range) * boardWidth]);
+                    }
+                    int count = sums[b] - (middle == 0 && state == 1u ? 1 : 0);
+                    before |= state << (b * 8);
+                    if (state == 0u) {
+                        state = count >= birthMin && count <= birthMax ? 1u : 0u;
+                    } else if (state != 1u || count < surviveMin || count > surviveMax) {
+                        state = (state + 1u) % uint(states);
+                    }
+                    cells |= state << (b * 8);
+                    if (y - range >= 0) {
+                        sums[b] -= int(rowSums[x + (y - range) * boardWidth]);
+                    }
+                }
+                next |= state << (b * 8);
+            }
+            currentBoard[word] = next;
+            statsWord(word, column * 4 - 1, y, cells, before);
+        }
+    }
+    statsFlush();
+}
@@ -0,0 +1,101 @@
+#include "ltlLife.h"
+#include "parallel.h"
+#include "boardMemory.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int createLtlBoard(st_ltlBoard *board, int width, int height) {
+    board->width = width;
+    board->height = height;
+    board->cells = (uint8_t *) allocateBoard((size_t) width * height * sizeof(uint8_t));
+    board->rowSums = (uint16_t *) allocateBoard((size_t) width * height * sizeof(uint16_t));
+    if (!board->cells || !board->rowSums) {
+        std::cout << "ERROR::LTL_LIFE::ALLOCATION_FAILED" << std::endl;
+        destroyLtlBoard(board);
+        return 0;
+    }
+    return 1;
+}
+
+void destroyLtlBoard(st_ltlBoard *board) {
+    freeBoard(board->cells, (size_t) board->width * board->height * sizeof(uint8_t));
+    freeBoard(board->rowSums, (size_t) board->width * board->height * sizeof(uint16_t));
+    board->cells = nullptr;
+    board->rowSums = nullptr;
+}
+
+static void sumRows(st_ltlBoard *board, int range, int begin, int end) {
+    const int width = board->width;
+    for (int y = begin; y < end; ++y) {
+        const uint8_t *row = board->cells + (long long) y * width;
+        uint16_t *sums = board->rowSums + (long long) y * width;
+        int sum = 0;
+        for (int x = 0; x < range && x < width; ++x) {
+            sum += row[x] == 1;
+        }
+        for (int x = 0; x < width; ++x) {
+            if (x + range < width) {
+                sum += row[x + range] == 1;
+            }
+            sums[x] = (uint16_t) sum;
+            if (x - range >= 0) {
+                sum -= row[x - range] == 1;
+            }
+        }
+    }
+}
+
+static void applyRows(st_ltlBoard *next, const st_ltlBoard *current, const st_ltlRule *rule, int begin, int end) {
+    const int width = current->width, height = current->height, range = rule->range;
+    std::vector<uint32_t> sums(width, 0);
+
+    // box sums of the first row of the band, then slide down one row at a time
+    for (int y = begin - range; y < begin + range && y < height; ++y) {
+        if (y >= 0) {
+            const uint16_t *rowSums = current->rowSums + (long long) y * width;
+            for (int x = 0; x < width; ++x) {
+                sums[x] += rowSums[x];
+            }
+        }
+    }
+
+    for (int y = begin; y < end; ++y) {
+        if (y + range < height) {
+            const uint16_t *add = current->rowSums + (long long) (y + range) * width;
+            for (int x = 0; x < width; ++x) {
+                sums[x] += add[x];
+            }
+        }
+
+        const uint8_t *row = current->cells + (long long) y * width;
+        uint8_t *out = next->cells + (long long) y * width;
+        for (int x = 0; x < width; ++x) {
+            int state = row[x];
+            int count = (int) sums[x] - (!rule->middle && state == 1);
+            if (state == 0) {
+                state = count >= rule->birthMin && count <= rule->birthMax;
+            } else if (state != 1 || count < rule->surviveMin || count > rule->surviveMax) {
+                state = (state + 1) % rule->states;
+            }
+            out[x] = (uint8_t) state;
+        }
+
+        if (y - range >= 0) {
+            const uint16_t *remove = current->rowSums + (long long) (y - range) * width;
+            for (int x = 0; x < width; ++x) {
+                sums[x] -= remove[x];
+            }
+        }
+    }
+}
+
+void stepLtl(st_ltlBoard *next, st_ltlBoard *current, const st_ltlRule *rule, int threads) {
+    parallelFor(current->height, threads, [=](int begin, int end) {
+        sumRows(current, rule->range, begin, end);
+    });
+    parallelFor(current->height, threads, [=](int begin, int end) {
+        applyRows(next, current, rule, begin, end);
+    });
+}
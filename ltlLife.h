@@ -0,0 +1,33 @@
+#ifndef CONWAY_LIFE_LTL_LIFE_H
+#define CONWAY_LIFE_LTL_LIFE_H
+
+#include "rule.h"
+
+#include <cstdint>
+
+// Larger than Life board, one byte of state per cell. Cells outside the board are dead.
+// rowSums is scratch space for the live cells within range of every cell along its row.
+struct st_ltlBoard {
+    int width;
+    int height;
+    uint8_t *cells;
+    uint16_t *rowSums;
+};
+
+int createLtlBoard(st_ltlBoard *board, int width, int height);
+
+void destroyLtlBoard(st_ltlBoard *board);
+
+inline int getLtlCell(const st_ltlBoard *board, int x, int y) {
+    return board->cells[x + (long long) y * board->width];
+}
+
+inline void setLtlCell(st_ltlBoard *board, int x, int y, int state) {
+    board->cells[x + (long long) y * board->width] = (uint8_t) state;
+}
+
+// Advances current by one generation into next with running box sums, O(1) per cell for any range.
+// Only the rowSums of current are written.
+void stepLtl(st_ltlBoard *next, st_ltlBoard *current, const st_ltlRule *rule, int threads);
+
+#endif
@@ -0,0 +1,57 @@
+#version 430 core
+layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) buffer Params {
+    int boardWidth;
+    int boardHeight;
+    int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
+    uint ruleTable[16];
+    int range;
+    int middle;
+    int birthMin;
+    int birthMax;
+    int surviveMin;
+    int surviveMax;
+};
+
+layout(std430, binding = 2) buffer OldBoard {
+    uint oldBoard[];
+};
+
+// live cells within range along the row, one entry per cell without padding
+layout(std430, binding = 3) buffer RowSums {
+    uint rowSums[];
+};
+
+const int SPAN = 64;  // cells per invocation
+
+uint isAlive(int x, int y) {
+    int index = x + 1 + (y + 1) * boardStride;
+    return ((oldBoard[index >> 2] >> ((index & 3) * 8)) & 0xFFu) == 1u ? 1u : 0u;
+}
+
+void main() {
+    int begin = int(gl_WorkGroupID.x) * SPAN;
+    int end = min(begin + SPAN, boardWidth);
+
+    // there can be more rows than workgroups along y, each workgroup steps down by their count
+    for (int y = int(gl_WorkGroupID.y); y < boardHeight; y += int(gl_NumWorkGroups.y)) {
+        uint sum = 0u;
+        for (int x = max(begin - range, 0); x < min(begin + range, boardWidth); ++x) {
+            sum += isAlive(x, y);
+        }
+        for (int x = begin; x < end; ++x) {
+            if (x + range < boardWidth) {
+                sum += isAlive(x + range, y);
+            }
+            rowSums[x + y * boardWidth] = sum;
+            if (x - range >= 0) {
+                sum -= isAlive(x - range, y);
+            }
+        }
+    }
+}
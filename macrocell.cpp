@@ -0,0 +1,175 @@
+#include "macrocell.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static int fail(FILE *f, const char *error, long long line) {
+    std::cout << "ERROR::MACROCELL::" << error << std::endl;
+    if (line) {
+        std::cout << "line " << line << std::endl;
+    }
+    if (f) {
+        fclose(f);
+    }
+    return 0;
+}
+
+static uint32_t parseLeaf(st_quadTree *tree, const char *line) {
+    uint64_t leaf = 0;
+    int x = 0, y = 0;
+    for (const char *c = line; *c && *c != '\n' && *c != '\r'; ++c) {
+        if (*c == '$') {
+            x = 0;
+            ++y;
+        } else if (x < 8 && y < 8 && (*c == '.' || *c == '*')) {
+            leaf |= (uint64_t) (*c == '*') << (8 * y + x++);
+        } else {
+            return UINT32_MAX;
+        }
+    }
+    return quadLeaf(tree, leaf);
+}
+
+int readMacrocell(st_macrocell *pattern, st_quadTree *tree, const char *file) {
+    FILE *f = fopen(file, "rb");
+    if (!f) {
+        std::cout << "ERROR::MACROCELL::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+
+    char line[512];
+    if (!fgets(line, sizeof(line), f) || std::strncmp(line, "[M2]", 4) != 0) {
+        return fail(f, "HEADER_MISSING", 1);
+    }
+    pattern->root = 0;
+    pattern->level = QUAD_LEAF_LEVEL;
+    pattern->generation = 0;
+    pattern->rule[0] = '\0';
+
+    // node and level of every line, index 0 stands for empty
+    std::vector<uint32_t> nodes(1, 0);
+    std::vector<int> levels(1, 0);
+    for (long long number = 2; fgets(line, sizeof(line), f); ++number) {
+        if (line[0] == '#') {
+            if (line[1] == 'R') {
+                std::sscanf(line + 2, " %127s", pattern->rule);
+            } else if (line[1] == 'G') {
+                std::sscanf(line + 2, " %lld", &pattern->generation);
+            }
+            continue;
+        }
+        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0') {
+            continue;
+        }
+
+        uint32_t node;
+        int level;
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$') {
+            node = parseLeaf(tree, line);
+            level = QUAD_LEAF_LEVEL;
+            if (node == UINT32_MAX) {
+                return fail(f, "BAD_LEAF", number);
+            }
+        } else {
+            unsigned long long children[4];
+            if (std::sscanf(line, "%d %llu %llu %llu %llu", &level, children, children + 1, children + 2,
+                            children + 3) != 5) {
+                return fail(f, "BAD_NODE", number);
+            }
+            if (level <= QUAD_LEAF_LEVEL) {
+                return fail(f, "MULTISTATE_UNSUPPORTED", number);
+            }
+            if (level > QUAD_MAX_LEVEL) {
+                return fail(f, "TOO_LARGE", number);
+            }
+            uint32_t ids[4];
+            for (int i = 0; i < 4; ++i) {
+                if (children[i] >= nodes.size() || (children[i] && levels[children[i]] != level - 1)) {
+                    return fail(f, "BAD_CHILD", number);
+                }
+                ids[i] = nodes[children[i]];
+            }
+            node = quadNode(tree, level, ids[0], ids[1], ids[2], ids[3]);
+            if (node == UINT32_MAX) {
+                return fail(f, "OUT_OF_MEMORY", number);
+            }
+        }
+        nodes.push_back(node);
+        levels.push_back(level);
+    }
+    fclose(f);
+
+    // the last node is the root
+    pattern->root = nodes.back();
+    pattern->level = levels.size() > 1 ? levels.back() : QUAD_LEAF_LEVEL;
+    return 1;
+}
+
+// Writes children before their parents, numbers holds the line of every node already written
+static int writeNode(FILE *f, const st_quadTree *tree, uint32_t node, std::vector<uint32_t> &numbers,
+                     uint32_t *next) {
+    if (!node || numbers[node]) {
+        return 1;
+    }
+    const st_quadNode *n = tree->nodes + node;
+    if (n->level == QUAD_LEAF_LEVEL) {
+        char line[8 * 9 + 2];
+        int length = 0;
+        for (int y = 0; y < 8; ++y) {
+            uint64_t row = (n->leaf >> (8 * y)) & 0xff;
+            for (int x = 0; row >> x; ++x) {
+                line[length++] = (row >> x) & 1 ? '*' : '.';
+            }
+            line[length++] = '$';
+        }
+        line[length++] = '\n';
+        line[length] = '\0';
+        if (fputs(line, f) == EOF) {
+            return 0;
+        }
+    } else {
+        for (uint32_t child: n->children) {
+            if (!writeNode(f, tree, child, numbers, next)) {
+                return 0;
+            }
+        }
+        if (fprintf(f, "%d %u %u %u %u\n", n->level, numbers[n->children[0]], numbers[n->children[1]],
+                    numbers[n->children[2]], numbers[n->children[3]]) < 0) {
+            return 0;
+        }
+    }
+    numbers[node] = (*next)++;
+    return 1;
+}
+
+int writeMacrocell(const char *file, const st_quadTree *tree, const st_macrocell *pattern) {
+    FILE *f = fopen(file, "wb");
+    if (!f) {
+        std::cout << "ERROR::MACROCELL::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+
+    int success = fprintf(f, "[M2] (conway_life)\n") >= 0;
+    if (success && pattern->rule[0]) {
+        success = fprintf(f, "#R %s\n", pattern->rule) >= 0;
+    }
+    if (success && pattern->generation) {
+        success = fprintf(f, "#G %lld\n", pattern->generation) >= 0;
+    }
+    if (success) {
+        std::vector<uint32_t> numbers(tree->count, 0);
+        uint32_t next = 1;
+        success = pattern->root ? writeNode(f, tree, pattern->root, numbers, &next) : fputs("$\n", f) != EOF;
+    }
+    if (fclose(f) != 0 || !success) {
+        std::cout << "ERROR::MACROCELL::WRITE_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,20 @@
+#ifndef CONWAY_LIFE_MACROCELL_H
+#define CONWAY_LIFE_MACROCELL_H
+
+#include "quadTree.h"
+
+// Golly macrocell (.mc) patterns. Every line of the file is one distinct node, either an 8x8 leaf ("$.*$**$") or
+// "level nw ne sw se" with children as 1-based line numbers and 0 for empty, so files load straight into the
+// quadtree without ever expanding the pattern. Only two-state patterns are supported.
+struct st_macrocell {
+    uint32_t root;
+    int level;
+    long long generation;
+    char rule[128];  // empty when the file has no rule
+};
+
+int readMacrocell(st_macrocell *pattern, st_quadTree *tree, const char *file);
+
+int writeMacrocell(const char *file, const st_quadTree *tree, const st_macrocell *pattern);
+
+#endif
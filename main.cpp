@@ -3,18 +3,29 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "shader.h"
+#include "conway.h"
+#include "rle.h"
+#include "macrocell.h"
+#include "checkpoint.h"
+#include "readback.h"
+#include "recorder.h"
+#include "replay.h"
+#include "frameExport.h"
+
 #include <iostream>
 #include <fstream>
-#include <streambuf>
 #include <random>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <thread>
 
-struct st_shaderInfo {
-    unsigned int type;
-    const char *file;
-} allShaders[] = {{GL_VERTEX_SHADER,   "vertex.glsl"},
-                  {GL_FRAGMENT_SHADER, "fragment.glsl"},
-                  {GL_COMPUTE_SHADER,  "lifeCompute.glsl"},
-                  {GL_COMPUTE_SHADER,  "texCompute.glsl"}};
+st_shaderInfo allShaders[] = {{GL_VERTEX_SHADER,   "vertex.glsl"},
+                              {GL_FRAGMENT_SHADER, "fragment.glsl"},
+                              {GL_COMPUTE_SHADER,  "texCompute.glsl"}};
 
 const int WIDTH = 800;
 const int HEIGHT = 800;
@@ -24,16 +35,32 @@ const int BOARD_WIDTH = BOARD_HEIGHT;
 
 const int TEX_SCALE = 1;  // matches local group size of texture compute shader
 
+const char *RULE = "B3/S23";  // or a Larger than Life rule, e.g. "R5,C2,M1,S33..57,B34..45,NM"
+const double DENSITY = .5;  // share of live cells in the random soup
+const char *PATTERN = nullptr;  // RLE or macrocell (.mc) file to start from instead of a random soup, its rule replaces RULE
+const char *EXPORT = "board.mc";  // macrocell file the board is written to when S is pressed
+const char *CHECKPOINT = nullptr;  // e.g. "board.ckpt", resumed from when present, written on C and on close
+const char *RECORDING = nullptr;  // every generation is recorded to this file when set
+const int KEYFRAME_INTERVAL = 256;  // recorded generations between keyframes, the most a seek has to decode
+const char *REPLAY = nullptr;  // recording to play back instead of running the rule, LEFT and RIGHT scrub through it
+const int SCRUB_SPEED = 8;  // generations per frame while scrubbing
+const char *VIDEO = nullptr;  // "run.y4m" or a PNG pattern such as "frames/%06d.png", renders offline when set
+const int VIDEO_EVERY = 1;  // generations per video frame
+const int VIDEO_FRAMES = 600;  // the window closes once this many frames are rendered
+const int VIDEO_FPS = 30;
+
+enum {
+    STABLE_CONTINUE,
+    STABLE_STOP,  // stepping stops, a video ends
+    STABLE_RESEED,  // a new random soup
+    STABLE_JUMP  // JUMP generations at a time, only the remainder modulo the period is stepped
+};
+const int ON_STABLE = STABLE_STOP;  // what happens once the board repeats with a period below CONWAY_HASH_RING
+const long long JUMP = 1000000;
+
 const float PERIOD = 1.f / 30.f;
 // const float PERIOD = .5f;
 
-float getRandom() {
-    static std::random_device rd;
-    static std::default_random_engine e(rd());
-    static std::uniform_int_distribution<> d(0, 1);
-    return (float) d(e);
-}
-
 void processInput(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
@@ -45,60 +72,96 @@ void errorCallback(int error, const char *description) {
     std::cout << description << std::endl;
 }
 
-int createShader(unsigned int *shader, unsigned int type, const char *file) {
-    *shader = glCreateShader(type);
-
-    std::ifstream t(file);
-    std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-    const char *c = str.c_str();
-
-    glShaderSource(*shader, 1, &c, nullptr);
-    glCompileShader(*shader);
+// board is a readback of the engine's board, stride bytes per row
+int exportBoard(const unsigned char *board, int stride, const char *rule, long long generation) {
+    st_quadTree tree;
+    st_macrocell pattern = {0, 0, generation};
+    std::strncpy(pattern.rule, rule, sizeof(pattern.rule) - 1);
+    int success = createQuadTree(&tree);
+    if (success) {
+        pattern.root = quadFromBytes(&tree, board + 1 + stride, stride, BOARD_WIDTH, BOARD_HEIGHT, &pattern.level);
+        success = pattern.root != UINT32_MAX && writeMacrocell(EXPORT, &tree, &pattern);
+        destroyQuadTree(&tree);
+    }
+    return success;
+}
 
-    int success;
-    glGetShaderiv(*shader, GL_COMPILE_STATUS, &success);
+int saveCheckpoint(const unsigned char *board, size_t size, int stride, const char *rule, int states,
+                   long long generation) {
+    st_checkpointHeader header = {};
+    header.topology = TOPOLOGY_FLAT;
+    header.width = BOARD_WIDTH;
+    header.height = BOARD_HEIGHT;
+    header.stride = stride;
+    header.states = states;
+    header.generation = generation;
+    std::strncpy(header.rule, rule, sizeof(header.rule) - 1);
+    std::strncpy(header.pattern, PATTERN ? PATTERN : "", sizeof(header.pattern) - 1);
+    return writeCheckpoint(CHECKPOINT, &header, board, size);
+}
 
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(*shader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::" << type << "::COMPILATION_FAILED" << std::endl;
-        std::cout << infoLog << std::endl;
+// rule as the engine names it, which is how checkpoints store it
+int normalizeRule(char *out, int size, const char *rule) {
+    st_rule parsed;
+    st_ltlRule ltlParsed;
+    if (rule[0] == 'R' ? !parseLtlRule(&ltlParsed, rule) : !parseRule(&parsed, rule)) {
+        return 0;
     }
-    return success;
+    rule[0] == 'R' ? formatLtlRule(out, size, &ltlParsed) : formatRule(out, size, &parsed);
+    return 1;
 }
 
-int createAndLinkProgram(unsigned int *program, st_shaderInfo *shaders, int shaderCount) {
-    unsigned int shaderIds[shaderCount];
-    int success, shaderStatus = createShader(shaderIds, shaders[0].type, shaders[0].file);
-    for (int i = 1; shaderStatus && i < shaderCount; ++i) {
-        shaderStatus = createShader(shaderIds + i, shaders[i].type, shaders[i].file);
+int main() {
+    st_replay replay = {};
+    if (REPLAY && !openReplay(&replay, REPLAY)) {
+        return -1;
+    }
+    if (REPLAY && (replay.header.width != BOARD_WIDTH || replay.header.height != BOARD_HEIGHT)) {
+        std::cout << "ERROR::REPLAY::BOARD_MISMATCH" << std::endl;
+        return -1;
     }
 
-    if (shaderStatus) {
-        *program = glCreateProgram();
-        for (int i = 0; i < shaderCount; ++i) {
-            glAttachShader(*program, shaderIds[i]);
+    const char *extension = PATTERN ? std::strrchr(PATTERN, '.') : nullptr;
+    const bool macrocell = extension && std::strcmp(extension, ".mc") == 0;
+    st_rleReader pattern = {};
+    st_quadTree tree = {};
+    st_macrocell cells = {};
+    if (!REPLAY && (macrocell ? !createQuadTree(&tree) || !readMacrocell(&cells, &tree, PATTERN)
+                              : PATTERN && !openRle(&pattern, PATTERN))) {
+        // the nodes read before the error
+        destroyQuadTree(&tree);
+        return -1;
+    }
+    const char *configuredRule = pattern.rule[0] ? pattern.rule : cells.rule[0] ? cells.rule : RULE;
+
+    // checkpointing is opt-in, and a checkpoint is only resumed from when it holds a run of this very board, rule
+    // and pattern. Anything else is refused rather than started over, which would overwrite it on close.
+    st_checkpoint checkpoint = {};
+    const bool resume = !REPLAY && CHECKPOINT && std::ifstream(CHECKPOINT).good();
+    if (resume) {
+        char rule[128] = {};
+        bool refused = !openCheckpoint(&checkpoint, CHECKPOINT);
+        if (!refused && (checkpoint.header.topology != TOPOLOGY_FLAT || checkpoint.header.width != BOARD_WIDTH ||
+                         checkpoint.header.height != BOARD_HEIGHT || checkpoint.header.stride < BOARD_WIDTH + 2)) {
+            std::cout << "ERROR::CHECKPOINT::BOARD_MISMATCH" << std::endl;
+            refused = true;
+        } else if (!refused && (!normalizeRule(rule, sizeof(rule), configuredRule) ||
+                                std::strcmp(rule, checkpoint.header.rule) != 0 ||
+                                std::strcmp(checkpoint.header.pattern, PATTERN ? PATTERN : "") != 0)) {
+            std::cout << "ERROR::CHECKPOINT::RULE_MISMATCH" << std::endl;
+            std::cout << CHECKPOINT << " is a run of " << checkpoint.header.rule << " from "
+                      << (checkpoint.header.pattern[0] ? checkpoint.header.pattern : "a random soup") << std::endl;
+            refused = true;
         }
-        glLinkProgram(*program);
-
-        glGetProgramiv(*program, GL_LINK_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetProgramInfoLog(*program, 512, nullptr, infoLog);
-            std::cout << "ERROR::PROGRAM::LINKING_FAILED" << std::endl;
-            std::cout << infoLog << std::endl;
+        if (refused) {
+            closeCheckpoint(&checkpoint);
+            closeRle(&pattern);
+            destroyQuadTree(&tree);
+            return -1;
         }
     }
+    const char *ruleString = REPLAY ? replay.header.rule : resume ? checkpoint.header.rule : configuredRule;
 
-    for (int i = 0; i < shaderCount; ++i) {
-        glDetachShader(*program, shaderIds[i]);
-        glDeleteShader(shaderIds[i]);
-    }
-
-    return shaderStatus && success;
-}
-
-int main() {
     glfwSetErrorCallback(errorCallback);
 
     if (!glfwInit()) {
@@ -107,7 +170,7 @@ int main() {
     }
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
@@ -127,10 +190,11 @@ int main() {
 
     std::cout << "GLVersion: " << GLVersion.major << "." << GLVersion.minor << std::endl;
 
-    unsigned int mainProgram, lifeComputeProgram, textureComputeProgram;
-    if (createAndLinkProgram(&mainProgram, allShaders, 2) &&
-        createAndLinkProgram(&lifeComputeProgram, allShaders + 2, 1) &&
-        createAndLinkProgram(&textureComputeProgram, allShaders + 3, 1)) {
+    st_conway engine;
+    unsigned int mainProgram = 0, textureComputeProgram = 0;
+    if (conwayCreate(&engine, BOARD_WIDTH, BOARD_HEIGHT, TOPOLOGY_FLAT, ruleString) &&
+        createAndLinkProgram(&mainProgram, allShaders, 2) &&
+        createAndLinkProgram(&textureComputeProgram, allShaders + 2, 1)) {
         glClearColor(1.f, 1.f, 1.f, 1.f);
 
         glEnable(GL_DEBUG_OUTPUT);
@@ -144,12 +208,9 @@ int main() {
                 1, 1, 1, 1
         };
 
-        unsigned int vao, vbo, params_ssbo, board1_ssbo, board2_ssbo;
+        unsigned int vao, vbo;
         glGenVertexArrays(1, &vao);
         glGenBuffers(1, &vbo);
-        glGenBuffers(1, &params_ssbo);
-        glGenBuffers(1, &board1_ssbo);
-        glGenBuffers(1, &board2_ssbo);
 
         glBindVertexArray(vao);
 
@@ -160,38 +221,52 @@ int main() {
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *) nullptr);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *) (2 * sizeof(float)));
 
-        const int params[] = {
-                BOARD_WIDTH,
-                BOARD_HEIGHT,
-                // neighborIndices:
-                -(BOARD_WIDTH + 2) - 1,  // BOTTOM LEFT
-                -(BOARD_WIDTH + 2),  // BOTTOM
-                -(BOARD_WIDTH + 2) + 1,  // BOTTOM RIGHT
-                -1,  // LEFT
-                // SKIP CENTER
-                +1,  // RIGHT
-                +(BOARD_WIDTH + 2) - 1,  // UPPER LEFT
-                +(BOARD_WIDTH + 2),  // UP
-                +(BOARD_WIDTH + 2) + 1  // UPPER RIGHT
-        };
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, params_ssbo);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, params_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(params), params, GL_DYNAMIC_COPY);
-
-        const int boardSize = (BOARD_WIDTH + 2) * (BOARD_HEIGHT + 2);
-        auto *board = (float *) (calloc(boardSize, sizeof(float)));
-        for (int i = 0; i < BOARD_WIDTH; ++i) {
-            for (int j = 0; j < BOARD_HEIGHT; ++j) {
-                board[i + 1 + (j + 1) * (BOARD_WIDTH + 2)] = getRandom();
+        int shift = 0;  // macrocell patterns larger than the board are shown one cell per 2^shift square, not run
+        std::vector<unsigned char> replayBoard;
+        long long replayFrame = 0;
+        if (REPLAY) {
+            // frames are decoded into a host copy of the board
+            replayBoard.assign(BOARD_WIDTH * BOARD_HEIGHT, 0);
+            seekReplay(&replay, replayFrame);
+            readReplay(&replay, replayBoard.data(), BOARD_WIDTH);
+            conwayImport(&engine, replayBoard.data(), BOARD_WIDTH, replay.header.firstGeneration);
+        } else if (resume) {
+            // the payload is the board buffer as saved, uploaded straight from the mapped file unless its rows are
+            // laid out for another stride
+            if (checkpoint.header.stride == engine.stride) {
+                conwayImportBoard(&engine, checkpoint.cells, checkpoint.header.generation);
+            } else {
+                conwayImport(&engine, checkpoint.cells + 1 + checkpoint.header.stride, checkpoint.header.stride,
+                             checkpoint.header.generation);
+            }
+            closeCheckpoint(&checkpoint);
+            closeRle(&pattern);
+            destroyQuadTree(&tree);
+        } else if (PATTERN) {
+            // decoded centered into a host board
+            std::vector<unsigned char> board(BOARD_WIDTH * BOARD_HEIGHT, 0);
+            if (macrocell) {
+                long long bounds[4] = {};
+                quadBounds(&tree, cells.root, bounds);
+                while (((bounds[2] - 1) >> shift) - (bounds[0] >> shift) >= BOARD_WIDTH ||
+                       ((bounds[3] - 1) >> shift) - (bounds[1] >> shift) >= BOARD_HEIGHT) {
+                    ++shift;
+                }
+                long long width = ((bounds[2] - 1) >> shift) - (bounds[0] >> shift) + 1;
+                long long height = ((bounds[3] - 1) >> shift) - (bounds[1] >> shift) + 1;
+                quadToBytes(&tree, cells.root, cells.level, board.data(), BOARD_WIDTH, BOARD_WIDTH, BOARD_HEIGHT,
+                            (BOARD_WIDTH - width) / 2 - (bounds[0] >> shift),
+                            (BOARD_HEIGHT - height) / 2 - (bounds[1] >> shift), shift);
+                destroyQuadTree(&tree);
+            } else {
+                readRleToBytes(&pattern, board.data(), BOARD_WIDTH, BOARD_WIDTH, BOARD_HEIGHT,
+                               (BOARD_WIDTH - pattern.width) / 2, (BOARD_HEIGHT - pattern.height) / 2);
+                closeRle(&pattern);
             }
+            conwayImport(&engine, board.data(), BOARD_WIDTH, cells.generation);
+        } else {
+            conwaySeed(&engine, std::random_device()(), DENSITY);
         }
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, board1_ssbo);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, board1_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, boardSize * sizeof(float), board, GL_STATIC_COPY);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, board2_ssbo);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, board2_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, boardSize * sizeof(float), nullptr, GL_STATIC_COPY);
-        free(board);
 
         unsigned int tex;
         glGenTextures(1, &tex);
@@ -206,35 +281,231 @@ int main() {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, BOARD_WIDTH * TEX_SCALE, BOARD_HEIGHT * TEX_SCALE, 0, GL_RGBA,
                      GL_FLOAT,
                      nullptr);
-        glBindImageTexture(0, tex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+        glClearTexImage(tex, 0, GL_RGBA, GL_FLOAT, nullptr);
+        // read back by the texture shader for the fade of two-state rules
+        glBindImageTexture(0, tex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+        long long drawnGeneration = engine.generation;
+
+        bool exportHeld = false, saveHeld = false;
+        // the hash ring is larger than small boards
+        st_readbackRing readback;
+        if (!createReadbackRing(&readback, std::max(engine.boardSize, CONWAY_HASHES_SIZE))) {
+            glDeleteTextures(1, &tex);
+            closeReplay(&replay);
+            conwayDestroy(&engine);
+            glDeleteProgram(mainProgram);
+            glDeleteProgram(textureComputeProgram);
+            glfwTerminate();
+            return -1;
+        }
+
+        // exports and checkpoints are written from a copy of the board on a thread of their own, one at a time,
+        // the callbacks only copy so the render thread never waits on the disk
+        std::thread writer;
+        auto writeBoard = [&writer](const unsigned char *board, size_t size,
+                                    std::function<void(const unsigned char *, size_t)> write) {
+            if (writer.joinable()) {
+                writer.join();
+            }
+            writer = std::thread([copy = std::vector<unsigned char>(board, board + size), write = std::move(write)] {
+                write(copy.data(), copy.size());
+            });
+        };
+        auto exportCallback = [&writeBoard, &engine](long long generation) {
+            return [&writeBoard, &engine, generation](const unsigned char *board, size_t size) {
+                writeBoard(board, size, [&engine, generation](const unsigned char *copy, size_t) {
+                    exportBoard(copy, engine.stride, engine.ruleName, generation);
+                });
+            };
+        };
+        auto checkpointCallback = [&writeBoard, &engine](long long generation) {
+            return [&writeBoard, &engine, generation](const unsigned char *board, size_t size) {
+                writeBoard(board, size, [&engine, generation](const unsigned char *copy, size_t copySize) {
+                    saveCheckpoint(copy, copySize, engine.stride, engine.ruleName, engine.rule.states, generation);
+                });
+            };
+        };
+
+        // every generation is read back through a ring of its own, like the video frames, and handed to the
+        // recorder's writer thread. The hash and export readbacks never queue behind it, and a step only waits when
+        // all of its slots are still in flight.
+        st_recorder recorder;
+        st_readbackRing recordReadback;
+        bool recording = RECORDING && !REPLAY &&
+                         openRecorder(&recorder, RECORDING, BOARD_WIDTH, BOARD_HEIGHT, engine.rule.states,
+                                      engine.ruleName, engine.generation, KEYFRAME_INTERVAL);
+        if (recording && !createReadbackRing(&recordReadback, engine.boardSize)) {
+            closeRecorder(&recorder);
+            recording = false;
+        }
+        auto recordBoard = [&]() {
+            auto callback = [&recorder, &engine](const unsigned char *board, size_t) {
+                recordFrame(&recorder, board + 1 + engine.stride, engine.stride);
+            };
+            while (!requestReadback(&recordReadback, engine.board, 0, engine.boardSize, callback)) {
+                pollReadbacks(&recordReadback, true);
+            }
+            pollReadbacks(&recordReadback, false);
+        };
+        if (recording) {
+            recordBoard();
+        }
+
+        // offline video: every frame is drawn into fbo, read back through its own ring and handed to the encoders
+        unsigned int fbo = 0, colorBuffer = 0;
+        st_frameEncoder encoder;
+        st_readbackRing frameReadback;
+        const bool video = VIDEO && openFrameEncoder(&encoder, VIDEO, WIDTH, HEIGHT, VIDEO_FPS, 0) &&
+                           createReadbackRing(&frameReadback, WIDTH * HEIGHT * 4);
+        int videoFrames = 0;
+        if (video) {
+            glGenFramebuffers(1, &fbo);
+            glGenRenderbuffers(1, &colorBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        // the hash ring is read back every half ring. A period it suggests is only a candidate until the board read
+        // back then matches the board read back candidate generations later, so a hash collision never triggers
+        // ON_STABLE. Callbacks drop their result when the board was replaced since their request, which the count of
+        // replacements tells even when a reseed leaves hashedFrom as it was.
+        int period = 0, candidate = 0;
+        long long candidateBoard = 0;  // replacements of the engine when the candidate was found
+        long long confirmFrom = -1;  // generation of the first board read back for the candidate, -1 before
+        std::vector<unsigned char> confirmBoard;
+        bool stopped = false;
+        // hash checks, confirmations, exports and checkpoints may not be dropped, a full ring is drained first
+        auto requestWhole = [&](unsigned int source, size_t size, readbackCallback callback) {
+            while (!requestReadback(&readback, source, 0, size, callback) && readback.pending) {
+                pollReadbacks(&readback, true);
+            }
+        };
+        auto checkPeriod = [&]() {
+            requestWhole(engine.hashes, CONWAY_HASHES_SIZE,
+                         [&engine, &candidate, &candidateBoard, gen = engine.generation, first = engine.hashedFrom,
+                          replaced = engine.replacements](const unsigned char *hashes, size_t) {
+                             if (replaced == engine.replacements && !candidate) {
+                                 candidate = conwayPeriod((const unsigned int *) hashes, gen, first);
+                                 candidateBoard = replaced;
+                             }
+                         });
+        };
+        auto confirmPeriod = [&]() {
+            if (!candidate || engine.replacements != candidateBoard) {
+                candidate = 0;
+                confirmFrom = -1;
+            } else if (confirmFrom < 0) {
+                confirmFrom = engine.generation;
+                requestWhole(engine.board, engine.boardSize, [&confirmBoard](const unsigned char *board, size_t size) {
+                    confirmBoard.assign(board, board + size);
+                });
+            } else if (engine.generation == confirmFrom + candidate) {
+                requestWhole(engine.board, engine.boardSize,
+                             [&, gen = engine.generation, replaced = engine.replacements](const unsigned char *board,
+                                                                                          size_t size) {
+                                 if (replaced == engine.replacements &&
+                                     std::equal(board, board + size, confirmBoard.begin(), confirmBoard.end())) {
+                                     period = candidate;
+                                     std::cout << "Stable at generation " << gen << " with period " << period
+                                               << std::endl;
+                                 }
+                                 candidate = 0;
+                                 confirmFrom = -1;
+                             });
+            }
+        };
 
-        int gen = 0;
         double referenceTime = glfwGetTime();
         while (!glfwWindowShouldClose(window)) {
             processInput(window);
 
+            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+                if (!exportHeld) {
+                    requestWhole(engine.board, engine.boardSize, exportCallback(engine.generation));
+                }
+                exportHeld = true;
+            } else {
+                exportHeld = false;
+            }
+            if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+                if (!saveHeld && CHECKPOINT) {
+                    requestWhole(engine.board, engine.boardSize, checkpointCallback(engine.generation));
+                }
+                saveHeld = true;
+            } else {
+                saveHeld = false;
+            }
+            pollReadbacks(&readback, false);
+
             double now = glfwGetTime();
-            while (now - referenceTime > PERIOD) {
-                referenceTime += PERIOD;
-                std::cout << "Generation: " << ++gen << std::endl;
-
-                unsigned int temp = board1_ssbo;
-                board1_ssbo = board2_ssbo;
-                board2_ssbo = temp;
-                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, board1_ssbo);
-                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, board2_ssbo);
-
-                glUseProgram(lifeComputeProgram);
-                glDispatchCompute(BOARD_WIDTH, BOARD_HEIGHT, 1);
-                glMemoryBarrier(GL_ALL_BARRIER_BITS);
+            if (REPLAY) {
+                // plays at the live rate, scrubbing moves faster either way
+                long long target = replayFrame;
+                for (; now - referenceTime > PERIOD; referenceTime += PERIOD) {
+                    ++target;
+                }
+                if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+                    target -= SCRUB_SPEED;
+                }
+                if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+                    target += SCRUB_SPEED;
+                }
+                target = std::max(0ll, std::min(target, replayFrameCount(&replay) - 1));
+                if (target != replayFrame && seekReplay(&replay, target) >= 0) {
+                    replayFrame = target;
+                    readReplay(&replay, replayBoard.data(), BOARD_WIDTH);
+                    conwayImport(&engine, replayBoard.data(), BOARD_WIDTH,
+                                 replay.header.firstGeneration + replayFrame);
+                    std::cout << "Generation: " << engine.generation << std::endl;
+                }
+            }
+            // a video steps as fast as it encodes, a live run at the rate of PERIOD
+            int steps = 0;
+            for (; now - referenceTime > PERIOD; referenceTime += PERIOD) {
+                ++steps;
+            }
+            if (video) {
+                steps = VIDEO_EVERY;
+            }
+            if (period && ON_STABLE == STABLE_STOP) {
+                stopped = true;
+                if (video) {
+                    glfwSetWindowShouldClose(window, true);
+                }
+            } else if (period && ON_STABLE == STABLE_RESEED) {
+                conwaySeed(&engine, std::random_device()(), DENSITY);
+            } else if (period && ON_STABLE == STABLE_JUMP) {
+                conwayJump(&engine, JUMP, period);
+                std::cout << "Generation: " << engine.generation << std::endl;
+            }
+            period = 0;
+            for (; !REPLAY && shift == 0 && !stopped && steps > 0; --steps) {
+                conwayStep(&engine, 1);
+                std::cout << "Generation: " << engine.generation << std::endl;
+
+                if (recording) {
+                    recordBoard();
+                }
+                if (ON_STABLE != STABLE_CONTINUE && engine.generation % (CONWAY_HASH_RING / 2) == 0) {
+                    checkPeriod();
+                }
+                if (ON_STABLE != STABLE_CONTINUE) {
+                    confirmPeriod();
+                }
             }
 
             glUseProgram(textureComputeProgram);
+            glUniform1i(0, (int) std::min(std::abs(engine.generation - drawnGeneration), 64ll));
+            drawnGeneration = engine.generation;
             glDispatchCompute(BOARD_WIDTH, BOARD_HEIGHT, 1);
             glMemoryBarrier(GL_ALL_BARRIER_BITS);
 
             glGenerateMipmap(GL_TEXTURE_2D);
 
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             glUseProgram(mainProgram);
@@ -242,13 +513,52 @@ int main() {
 
             glDrawArrays(GL_TRIANGLES, 0, 6);
 
+            if (video) {
+                auto callback = [&encoder](const unsigned char *pixels, size_t) {
+                    encodeFrame(&encoder, pixels);
+                };
+                while (!requestPixels(&frameReadback, 0, 0, WIDTH, HEIGHT, callback)) {
+                    pollReadbacks(&frameReadback, true);
+                }
+                pollReadbacks(&frameReadback, false);
+                if (++videoFrames == VIDEO_FRAMES) {
+                    glfwSetWindowShouldClose(window, true);
+                }
+
+                // preview in the window
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+                glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            }
+
             glfwSwapBuffers(window);
             glfwPollEvents();
         }
+
+        // finish whatever is in flight, then save the final board when checkpointing
+        pollReadbacks(&readback, true);
+        if (!REPLAY && CHECKPOINT) {
+            requestWhole(engine.board, engine.boardSize, checkpointCallback(engine.generation));
+        }
+        destroyReadbackRing(&readback);
+        if (writer.joinable()) {
+            writer.join();
+        }
+        if (video) {
+            destroyReadbackRing(&frameReadback);
+            closeFrameEncoder(&encoder);
+            glDeleteRenderbuffers(1, &colorBuffer);
+            glDeleteFramebuffers(1, &fbo);
+        }
+        if (recording) {
+            destroyReadbackRing(&recordReadback);
+            closeRecorder(&recorder);
+        }
+        closeReplay(&replay);
     }
 
+    conwayDestroy(&engine);
     glDeleteProgram(mainProgram);
-    glDeleteProgram(lifeComputeProgram);
     glDeleteProgram(textureComputeProgram);
 
     glfwTerminate();
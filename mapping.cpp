@@ -0,0 +1,132 @@
+#include "mapping.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+void *mapFile(const char *file, size_t *size) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER length;
+    HANDLE mapping = GetFileSizeEx(handle, &length) && length.QuadPart > 0
+                     ? CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(handle);
+    if (!mapping) {
+        return nullptr;
+    }
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    *size = (size_t) length.QuadPart;
+    return data;
+#else
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat status = {};
+    void *data = fstat(fd, &status) == 0 && status.st_size > 0
+                 ? mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    *size = (size_t) status.st_size;
+    return data;
+#endif
+}
+
+void unmapFile(void *data, size_t size) {
+#ifdef _WIN32
+    (void) size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+void *mapFileWritable(const char *file, size_t size) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(file, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READWRITE, (DWORD) ((uint64_t) size >> 32),
+                                        (DWORD) size, nullptr);
+    CloseHandle(handle);
+    if (!mapping) {
+        return nullptr;
+    }
+    void *data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    CloseHandle(mapping);
+    return data;
+#else
+    int fd = open(file, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // a sparse file, untouched pages read as zero and take no disk space
+    struct stat status = {};
+    void *data = fstat(fd, &status) == 0 && ((size_t) status.st_size >= size || ftruncate(fd, (off_t) size) == 0)
+                 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    return data == MAP_FAILED ? nullptr : data;
+#endif
+}
+
+// widens [offset, offset + length) to whole pages
+static void pageRange(size_t *offset, size_t *length) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t page = info.dwPageSize;
+#else
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+#endif
+    const size_t end = *offset + *length;
+    *offset -= *offset % page;
+    *length = (end + page - 1) / page * page - *offset;
+}
+
+void adviseMapping(void *data, size_t offset, size_t length, int advice) {
+    pageRange(&offset, &length);
+#ifdef _WIN32
+    if (advice == MAPPING_WILL_NEED) {
+        WIN32_MEMORY_RANGE_ENTRY range = {(char *) data + offset, length};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    const int advices[] = {MADV_SEQUENTIAL, MADV_WILLNEED, MADV_DONTNEED};
+    madvise((char *) data + offset, length, advices[advice]);
+#endif
+}
+
+void flushMapping(void *data, size_t offset, size_t length) {
+    pageRange(&offset, &length);
+#ifdef _WIN32
+    FlushViewOfFile((char *) data + offset, length);
+#else
+    msync((char *) data + offset, length, MS_ASYNC);
+#endif
+}
+
+int replaceFile(const char *temporary, const char *file) {
+#ifdef _WIN32
+    return MoveFileExA(temporary, file, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temporary, file) == 0;
+#endif
+}
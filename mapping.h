@@ -0,0 +1,29 @@
+#ifndef CONWAY_LIFE_MAPPING_H
+#define CONWAY_LIFE_MAPPING_H
+
+#include <cstddef>
+
+// Maps a whole file read-only. Returns null when the file is missing or empty.
+void *mapFile(const char *file, size_t *size);
+
+void unmapFile(void *data, size_t size);
+
+// Maps file read-write, creating it or growing it to size first. Returns null on failure.
+void *mapFileWritable(const char *file, size_t size);
+
+enum {
+    MAPPING_SEQUENTIAL,  // read ahead aggressively
+    MAPPING_WILL_NEED,  // start reading the range in now
+    MAPPING_DONT_NEED  // drop the range from the mapping, written pages are kept by the file
+};
+
+// Hint about the pages covering [offset, offset + length) of a mapping, ignored where the platform has no match
+void adviseMapping(void *data, size_t offset, size_t length, int advice);
+
+// Starts writing the pages covering the range back to the file without waiting for it
+void flushMapping(void *data, size_t offset, size_t length);
+
+// Renames temporary over file, replacing it atomically where the platform allows
+int replaceFile(const char *temporary, const char *file);
+
+#endif
@@ -3,20 +3,16 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "shader.h"
+#include "conway.h"
+
 #include <iostream>
-#include <fstream>
-#include <streambuf>
 #include <random>
 #include <cmath>
 
-struct st_shaderInfo {
-    unsigned int type;
-    const char *file;
-} allShaders[] = {{GL_VERTEX_SHADER,   "mobiusVertex.glsl"},
-                  {GL_FRAGMENT_SHADER, "fragment.glsl"},
-                  {GL_COMPUTE_SHADER,  "mobiusEdgesCompute.glsl"},
-                  {GL_COMPUTE_SHADER,  "lifeCompute.glsl"},
-                  {GL_COMPUTE_SHADER,  "texCompute.glsl"}};
+st_shaderInfo allShaders[] = {{GL_VERTEX_SHADER,   "mobiusVertex.glsl"},
+                              {GL_FRAGMENT_SHADER, "fragment.glsl"},
+                              {GL_COMPUTE_SHADER,  "texCompute.glsl"}};
 
 const int WIDTH = 800;
 const int HEIGHT = 800;
@@ -32,16 +28,11 @@ const float THICKNESS = .8f;
 
 const float PI = 3.1415f;
 
+const char *RULE = "B3/S23";
+
 const float PERIOD = 1.f / 30.f;
 // const float PERIOD = .5f;
 
-float getRandom() {
-    static std::random_device rd;
-    static std::default_random_engine e(rd());
-    static std::uniform_int_distribution<> d(0, 1);
-    return (float) d(e);
-}
-
 void processInput(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
@@ -53,59 +44,6 @@ void errorCallback(int error, const char *description) {
     std::cout << description << std::endl;
 }
 
-int createShader(unsigned int *shader, unsigned int type, const char *file) {
-    *shader = glCreateShader(type);
-
-    std::ifstream t(file);
-    std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-    const char *c = str.c_str();
-
-    glShaderSource(*shader, 1, &c, nullptr);
-    glCompileShader(*shader);
-
-    int success;
-    glGetShaderiv(*shader, GL_COMPILE_STATUS, &success);
-
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(*shader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::" << type << "::COMPILATION_FAILED" << std::endl;
-        std::cout << infoLog << std::endl;
-    }
-    return success;
-}
-
-int createAndLinkProgram(unsigned int *program, st_shaderInfo *shaders, int shaderCount) {
-    unsigned int shaderIds[shaderCount];
-    int success, shaderStatus = createShader(shaderIds, shaders[0].type, shaders[0].file);
-    for (int i = 1; shaderStatus && i < shaderCount; ++i) {
-        shaderStatus = createShader(shaderIds + i, shaders[i].type, shaders[i].file);
-    }
-
-    if (shaderStatus) {
-        *program = glCreateProgram();
-        for (int i = 0; i < shaderCount; ++i) {
-            glAttachShader(*program, shaderIds[i]);
-        }
-        glLinkProgram(*program);
-
-        glGetProgramiv(*program, GL_LINK_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetProgramInfoLog(*program, 512, nullptr, infoLog);
-            std::cout << "ERROR::PROGRAM::LINKING_FAILED" << std::endl;
-            std::cout << infoLog << std::endl;
-        }
-    }
-
-    for (int i = 0; i < shaderCount; ++i) {
-        glDetachShader(*program, shaderIds[i]);
-        glDeleteShader(shaderIds[i]);
-    }
-
-    return shaderStatus && success;
-}
-
 int main() {
     glfwSetErrorCallback(errorCallback);
 
@@ -115,7 +53,7 @@ int main() {
     }
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
@@ -136,11 +74,11 @@ int main() {
 
     std::cout << "GLVersion: " << GLVersion.major << "." << GLVersion.minor << std::endl;
 
-    unsigned int mainProgram, edgesComputeProgram, lifeComputeProgram, textureComputeProgram;
-    if (createAndLinkProgram(&mainProgram, allShaders, 2) &&
-        createAndLinkProgram(&edgesComputeProgram, allShaders + 2, 1) &&
-        createAndLinkProgram(&lifeComputeProgram, allShaders + 3, 1) &&
-        createAndLinkProgram(&textureComputeProgram, allShaders + 4, 1)) {
+    st_conway engine;
+    unsigned int mainProgram = 0, textureComputeProgram = 0;
+    if (conwayCreate(&engine, BOARD_WIDTH, BOARD_HEIGHT, TOPOLOGY_MOBIUS, RULE) &&
+        createAndLinkProgram(&mainProgram, allShaders, 2) &&
+        createAndLinkProgram(&textureComputeProgram, allShaders + 2, 1)) {
         glClearColor(1.f, 1.f, 1.f, 1.f);
 
         glEnable(GL_DEPTH_TEST);
@@ -216,12 +154,9 @@ int main() {
             vertices[6 * 5 * i + 5 * 5 + 4] = v0;
         }
 
-        unsigned int vao, vbo, params_ssbo, board1_ssbo, board2_ssbo;
+        unsigned int vao, vbo;
         glGenVertexArrays(1, &vao);
         glGenBuffers(1, &vbo);
-        glGenBuffers(1, &params_ssbo);
-        glGenBuffers(1, &board1_ssbo);
-        glGenBuffers(1, &board2_ssbo);
 
         glBindVertexArray(vao);
 
@@ -232,36 +167,7 @@ int main() {
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) nullptr);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (3 * sizeof(float)));
 
-        const int params[] = {
-                BOARD_WIDTH,
-                BOARD_HEIGHT,
-                // neighborIndices:
-                -(BOARD_WIDTH + 2) - 1,  // BOTTOM LEFT
-                -(BOARD_WIDTH + 2),  // BOTTOM
-                -(BOARD_WIDTH + 2) + 1,  // BOTTOM RIGHT
-                -1,  // LEFT
-                // SKIP CENTER
-                +1,  // RIGHT
-                +(BOARD_WIDTH + 2) - 1,  // UPPER LEFT
-                +(BOARD_WIDTH + 2),  // UP
-                +(BOARD_WIDTH + 2) + 1  // UPPER RIGHT
-        };
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, params_ssbo);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, params_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(params), params, GL_DYNAMIC_COPY);
-
-        float board[(BOARD_WIDTH + 2) * (BOARD_HEIGHT + 2)];
-        bool boardFlag = true;
-        for (int i = 0; i < BOARD_WIDTH; ++i) {
-            for (int j = 0; j < BOARD_HEIGHT; ++j) {
-                board[i + 1 + (j + 1) * (BOARD_WIDTH + 2)] = getRandom();
-            }
-        }
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, board1_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(board), board, GL_DYNAMIC_COPY);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, board2_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(board), nullptr,
-                     GL_DYNAMIC_COPY);  // set size for the second buffer??
+        conwaySeed(&engine, std::random_device()(), .5);
 
         unsigned int tex;
         glGenTextures(1, &tex);
@@ -276,13 +182,14 @@ int main() {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, BOARD_WIDTH * TEX_SCALE, BOARD_HEIGHT * TEX_SCALE, 0, GL_RGBA,
                      GL_FLOAT,
                      nullptr);
-        glBindImageTexture(0, tex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+        glClearTexImage(tex, 0, GL_RGBA, GL_FLOAT, nullptr);
+        // read back by the texture shader for the fade of two-state rules
+        glBindImageTexture(0, tex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
 
         float rotx = .0f;
         float roty = PI * 2.f / 3.f;
         float rotz = .0f;
 
-        int gen = 0;
         double referenceTime = glfwGetTime();
         while (!glfwWindowShouldClose(window)) {
             processInput(window);
@@ -290,28 +197,11 @@ int main() {
             double now = glfwGetTime();
             while (now - referenceTime > PERIOD) {
                 referenceTime += PERIOD;
-                std::cout << "Generation: " << ++gen << std::endl;
-
-                boardFlag = !boardFlag;
-                if (boardFlag) {
-                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, board1_ssbo);
-                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, board2_ssbo);
-                } else {
-                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, board2_ssbo);
-                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, board1_ssbo);
-                }
-
-                glUseProgram(edgesComputeProgram);
-                glDispatchCompute(BOARD_HEIGHT, 1, 1);
-
-                glMemoryBarrier(GL_ALL_BARRIER_BITS);
-
-                glUseProgram(lifeComputeProgram);
-                glDispatchCompute(BOARD_WIDTH, BOARD_HEIGHT, 1);
-
-                glMemoryBarrier(GL_ALL_BARRIER_BITS);
+                conwayStep(&engine, 1);
+                std::cout << "Generation: " << engine.generation << std::endl;
 
                 glUseProgram(textureComputeProgram);
+                glUniform1i(0, 1);
                 glDispatchCompute(BOARD_WIDTH, BOARD_HEIGHT, 1);
 
                 glMemoryBarrier(GL_ALL_BARRIER_BITS);
@@ -333,9 +223,8 @@ int main() {
         }
     }
 
+    conwayDestroy(&engine);
     glDeleteProgram(mainProgram);
-    glDeleteProgram(edgesComputeProgram);
-    glDeleteProgram(lifeComputeProgram);
     glDeleteProgram(textureComputeProgram);
 
     glfwTerminate();
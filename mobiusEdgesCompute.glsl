@@ -5,14 +5,28 @@ layout(std430, binding = 0) buffer Params {
     int boardWidth;
     int boardHeight;
     int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
 };
 
 layout(std430, binding = 2) buffer CurrentBoard {
-    float board[];
+    uint board[];
 };
 
+uint getState(int index) {
+    return (board[index >> 2] >> ((index & 3) * 8)) & 0xFFu;
+}
+
+void setState(int index, uint state) {
+    int shift = (index & 3) * 8;
+    board[index >> 2] = (board[index >> 2] & ~(0xFFu << shift)) | (state << shift);
+}
+
 void main() {
-    uint i = gl_WorkGroupID.x;
-    board[(i + 1) * (boardWidth + 2)] = board[boardWidth + (boardHeight - i) * (boardWidth + 2)];
-    board[boardWidth + 1 + (i + 1) * (boardWidth + 2)] = board[1 + (boardHeight - i) * (boardWidth + 2)];
+    for (int i = int(gl_WorkGroupID.x); i < boardHeight; i += int(gl_NumWorkGroups.x)) {
+        setState((i + 1) * boardStride, getState(boardWidth + (boardHeight - i) * boardStride));
+        setState(boardWidth + 1 + (i + 1) * boardStride, getState(1 + (boardHeight - i) * boardStride));
+    }
 }
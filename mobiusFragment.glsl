@@ -1,11 +1,16 @@
 #version 430 core
 layout (std430, binding = 0) buffer Board {
-    float board[];
+    uint board[];
 };
 
 layout (std430, binding = 1) buffer Params {
     int boardWidth;
     int boardHeight;
+    int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
 };
 
 in vec2 uv;
@@ -43,6 +48,9 @@ void main(){
     if (dx <= zero || dy <= zero) {
         color = vec3(0.5, 0.0, 0.0);
     } else {
-        color = vec3(0.0, 0.0, (board[x + 1 + (y + 1) * (boardWidth + 2)] + 1.0) / 2.0) * depth;
+        int index = x + 1 + (y + 1) * boardStride;
+        uint state = (board[index >> 2] >> ((index & 3) * 8)) & 0xFFu;
+        float boardVal = state == 0u ? 0.0 : exp2(1.0 - float(state));
+        color = vec3(0.0, 0.0, (boardVal + 1.0) / 2.0) * depth;
     }
 }
@@ -0,0 +1,117 @@
+#include "numaPlacement.h"
+#include "parallel.h"
+#include "cpuLife.h"
+#include "soup.h"
+#include "boardMemory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+
+// Read bandwidth of one thread pinned to each node from memory placed on each node, local on the diagonal, then the
+// CPU engine stepping a board with thread pinning and first touch placement on and off, and how much of the board
+// huge pages cover. Without placement the board is first touched on node 0 only, as by a single thread loading it.
+
+const size_t BUFFER_BYTES = 1 << 30;
+const int PASSES = 4;
+const int BOARD_SIZE = 8192;
+const int GENERATIONS = 50;
+const char *RULE = "B3/S23";
+
+static double readBandwidth(int cpuNode, int memoryNode) {
+    double result = 0;
+    // a thread of its own, so that the pinning ends with it
+    std::thread([&] {
+        uint64_t *buffer = (uint64_t *) malloc(BUFFER_BYTES);
+        if (!buffer) {
+            std::cout << "ERROR::NUMA_BENCH::ALLOCATION_FAILED" << std::endl;
+            return;
+        }
+        bindMemory(buffer, BUFFER_BYTES, memoryNode);
+        pinThreadToNode(memoryNode);
+        memset(buffer, 1, BUFFER_BYTES);
+        pinThreadToNode(cpuNode);
+
+        uint64_t sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; ++pass) {
+            for (size_t i = 0; i < BUFFER_BYTES / sizeof(uint64_t); i += 4) {
+                sum += buffer[i] ^ buffer[i + 1] ^ buffer[i + 2] ^ buffer[i + 3];
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        // keeps the loop from being optimized away
+        result = sum == 42 ? 0 : (double) BUFFER_BYTES * PASSES / seconds / 1e9;
+        free(buffer);
+    }).join();
+    return result;
+}
+
+// 0 when the boards cannot be allocated
+static double stepRate(int pinned, int placed) {
+    st_rule rule;
+    st_ruleCircuit circuit;
+    parseRule(&rule, RULE);
+    compileRule(&circuit, &rule);
+    st_lifeBoard current, next;
+    int created = 0;
+    auto create = [&] {
+        created = createLifeBoard(&current, BOARD_SIZE, BOARD_SIZE, 2);
+        if (created && !createLifeBoard(&next, BOARD_SIZE, BOARD_SIZE, 2)) {
+            destroyLifeBoard(&current);
+            created = 0;
+        }
+        if (created) {
+            seedLifeBoard(&current, 1, .5, 0);
+        }
+    };
+    if (placed) {
+        setThreadPinning(pinned);
+        create();
+    } else {
+        // threads inherit the CPUs of the thread that starts them, so every band is first touched on node 0
+        setThreadPinning(0);
+        std::thread([&] {
+            pinThreadToNode(0);
+            create();
+        }).join();
+        setThreadPinning(pinned);
+    }
+    if (!created) {
+        return 0;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < GENERATIONS; ++i) {
+        stepLife(&next, &current, &circuit, 0, nullptr);
+        std::swap(current, next);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Huge pages: " << (hugePageBytes(current.cells, lifeBoardSize(&current)) >> 20) << " of "
+              << (lifeBoardSize(&current) >> 20) << " MiB of the board" << std::endl;
+    destroyLifeBoard(&current);
+    destroyLifeBoard(&next);
+    return (double) BOARD_SIZE * BOARD_SIZE * GENERATIONS / seconds / 1e9;
+}
+
+int main() {
+    const int nodes = numaNodes();
+    std::cout << "NUMA nodes: " << nodes << ", threads: " << hardwareThreads() << std::endl;
+    std::cout << "Read GB/s, rows are the node of the thread, columns the node of the memory" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int cpuNode = 0; cpuNode < nodes; ++cpuNode) {
+        std::cout << "node " << cpuNode << ":";
+        for (int memoryNode = 0; memoryNode < nodes; ++memoryNode) {
+            std::cout << " " << std::setw(8) << readBandwidth(cpuNode, memoryNode);
+        }
+        std::cout << std::endl;
+    }
+    const double placed = stepRate(1, 1), unpinned = stepRate(0, 1), unplaced = stepRate(1, 0);
+    std::cout << "Step Gcells/s pinned and placed: " << placed << ", unpinned: " << unpinned
+              << ", pinned with the board on node 0: " << unplaced << std::endl;
+    return 0;
+}
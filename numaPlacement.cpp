@@ -0,0 +1,141 @@
+#include "numaPlacement.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <filesystem>
+#endif
+#ifdef CONWAY_LIFE_LIBNUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+#if defined(__linux__)
+
+// The CPUs this process may run on, node by node, and the node of each
+struct st_numaTopology {
+    int nodes;
+    std::vector<int> cpus;
+    std::vector<int> nodeOf;  // by CPU
+};
+
+static const st_numaTopology &numaTopology() {
+    static const st_numaTopology topology = [] {
+        st_numaTopology result = {1, {}, {}};
+#ifdef CONWAY_LIFE_LIBNUMA
+        if (numa_available() >= 0) {
+            result.nodes = numa_num_configured_nodes();
+        }
+#else
+        int nodes = 0;
+        while (std::filesystem::exists("/sys/devices/system/node/node" + std::to_string(nodes))) {
+            ++nodes;
+        }
+        result.nodes = std::max(nodes, 1);
+#endif
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(allowed), &allowed);
+        result.nodeOf.assign(CPU_SETSIZE, 0);
+        for (int node = 0; node < result.nodes; ++node) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (!CPU_ISSET(cpu, &allowed)) {
+                    continue;
+                }
+#ifdef CONWAY_LIFE_LIBNUMA
+                const bool onNode = result.nodes == 1 || numa_node_of_cpu(cpu) == node;
+#else
+                const bool onNode = result.nodes == 1 || std::filesystem::exists(
+                        "/sys/devices/system/node/node" + std::to_string(node) + "/cpu" + std::to_string(cpu));
+#endif
+                if (onNode) {
+                    result.cpus.push_back(cpu);
+                    result.nodeOf[cpu] = node;
+                }
+            }
+        }
+        return result;
+    }();
+    return topology;
+}
+
+static void pinToCpus(const std::vector<int> &cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    if (!cpus.empty()) {
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+}
+
+int numaNodes() {
+    return numaTopology().nodes;
+}
+
+int currentNumaNode() {
+    const int cpu = sched_getcpu();
+    return cpu >= 0 && cpu < CPU_SETSIZE ? numaTopology().nodeOf[cpu] : 0;
+}
+
+void pinThread(int index, int count) {
+    const st_numaTopology &topology = numaTopology();
+    if (!topology.cpus.empty()) {
+        pinToCpus({topology.cpus[(size_t) index * topology.cpus.size() / count]});
+    }
+}
+
+void pinThreadToNode(int node) {
+    const st_numaTopology &topology = numaTopology();
+    std::vector<int> cpus;
+    for (int cpu : topology.cpus) {
+        if (topology.nodeOf[cpu] == node) {
+            cpus.push_back(cpu);
+        }
+    }
+    pinToCpus(cpus);
+}
+
+void bindMemory(void *data, size_t size, int node) {
+    const uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = ((uintptr_t) data + page - 1) / page * page, end = ((uintptr_t) data + size) / page * page;
+    if (numaNodes() <= 1 || end <= begin) {
+        return;
+    }
+    // MPOL_PREFERRED, falling back to other nodes rather than failing when the node is full. numa_tonode_memory
+    // binds strictly and numa_set_preferred covers the whole thread, so libnuma builds call mbind as well.
+    const unsigned long mask = 1ul << node;
+#ifdef CONWAY_LIFE_LIBNUMA
+    mbind((void *) begin, end - begin, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+#else
+    syscall(SYS_mbind, begin, end - begin, 1, &mask, sizeof(mask) * 8, 0);
+#endif
+}
+
+#else
+
+int numaNodes() {
+    return 1;
+}
+
+int currentNumaNode() {
+    return 0;
+}
+
+void pinThread(int, int) {
+}
+
+void pinThreadToNode(int) {
+}
+
+void bindMemory(void *, size_t, int) {
+}
+
+#endif
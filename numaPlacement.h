@@ -0,0 +1,24 @@
+#ifndef CONWAY_LIFE_NUMA_PLACEMENT_H
+#define CONWAY_LIFE_NUMA_PLACEMENT_H
+
+#include <cstddef>
+
+// Placement of threads and memory on NUMA hosts. Built with libnuma (CONWAY_LIFE_LIBNUMA) its calls are used,
+// otherwise Linux gets the same from sched_setaffinity, the mbind system call and sysfs, and other platforms one node.
+int numaNodes();
+
+// Node of the CPU the calling thread runs on
+int currentNumaNode();
+
+// Pins the calling thread to one CPU, thread index of count spread over the CPUs node by node, so that threads with
+// neighboring indices, which step neighboring bands, share a node
+void pinThread(int index, int count);
+
+// Pins the calling thread to the CPUs of node
+void pinThreadToNode(int node);
+
+// Asks for the whole pages of [data, data + size) to be placed on node when first touched, or on another node when
+// it is full
+void bindMemory(void *data, size_t size, int node);
+
+#endif
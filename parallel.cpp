@@ -0,0 +1,65 @@
+#include "parallel.h"
+#include "numaPlacement.h"
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+static std::atomic<int> pinning{-1};  // -1 until decided from the host
+
+int hardwareThreads() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n ? (int) n : 1;
+}
+
+void setThreadPinning(int enabled) {
+    pinning = enabled ? 1 : 0;
+}
+
+int threadPinning() {
+    if (pinning < 0) {
+        pinning = numaNodes() > 1 ? 1 : 0;
+    }
+    return pinning;
+}
+
+void parallelFor(int count, int threads, const std::function<void(int, int)> &fn) {
+    if (threads <= 0) {
+        threads = hardwareThreads();
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads <= 1) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+
+    // the calling thread keeps its affinity and only waits
+    if (threadPinning()) {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&fn, t, threads, count] {
+                pinThread(t, threads);
+                fn((int) ((long long) count * t / threads), (int) ((long long) count * (t + 1) / threads));
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(fn, (int) ((long long) count * t / threads), (int) ((long long) count * (t + 1) / threads));
+    }
+    fn(0, (int) ((long long) count / threads));
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef CONWAY_LIFE_PARALLEL_H
+#define CONWAY_LIFE_PARALLEL_H
+
+#include <functional>
+
+// Splits [0, count) into contiguous bands and runs fn(begin, end) for each band on its own thread.
+// threads <= 0 uses every hardware thread.
+void parallelFor(int count, int threads, const std::function<void(int, int)> &fn);
+
+int hardwareThreads();
+
+// With pinning on, parallelFor runs every band on a thread of its own pinned by pinThread, so that band t of a board
+// is stepped on the node it was first touched on. On by default on hosts with more than one NUMA node.
+void setThreadPinning(int enabled);
+
+int threadPinning();
+
+#endif
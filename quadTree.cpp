@@ -0,0 +1,225 @@
+#include "quadTree.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+static uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+static uint64_t hashNode(const st_quadNode *node) {
+    if (node->level == QUAD_LEAF_LEVEL) {
+        return mix(node->leaf);
+    }
+    uint64_t h = mix(((uint64_t) node->children[0] << 32 | node->children[1]) + (uint64_t) node->level);
+    return mix(h ^ ((uint64_t) node->children[2] << 32 | node->children[3]));
+}
+
+static int sameNode(const st_quadNode *a, const st_quadNode *b) {
+    return a->level == b->level && a->leaf == b->leaf && a->children[0] == b->children[0] &&
+           a->children[1] == b->children[1] && a->children[2] == b->children[2] && a->children[3] == b->children[3];
+}
+
+static int grow(st_quadTree *tree) {
+    uint32_t capacity = tree->capacity * 2, tableSize = tree->tableSize * 2;
+    auto *nodes = (st_quadNode *) realloc(tree->nodes, capacity * sizeof(st_quadNode));
+    auto *table = (uint32_t *) calloc(tableSize, sizeof(uint32_t));
+    if (!nodes || !table || tableSize < tree->tableSize) {
+        if (nodes) {
+            tree->nodes = nodes;
+        }
+        free(table);
+        std::cout << "ERROR::QUAD_TREE::OUT_OF_MEMORY" << std::endl;
+        return 0;
+    }
+    for (uint32_t i = 1; i < tree->count; ++i) {
+        uint32_t slot = (uint32_t) hashNode(nodes + i) & (tableSize - 1);
+        while (table[slot]) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        table[slot] = i;
+    }
+    free(tree->table);
+    tree->nodes = nodes;
+    tree->capacity = capacity;
+    tree->table = table;
+    tree->tableSize = tableSize;
+    return 1;
+}
+
+static uint32_t intern(st_quadTree *tree, const st_quadNode *node) {
+    uint32_t slot = (uint32_t) hashNode(node) & (tree->tableSize - 1);
+    for (; tree->table[slot]; slot = (slot + 1) & (tree->tableSize - 1)) {
+        if (sameNode(tree->nodes + tree->table[slot], node)) {
+            return tree->table[slot];
+        }
+    }
+
+    // keep the table at most half full
+    if (tree->count == tree->capacity || tree->count * 2 >= tree->tableSize) {
+        if (!grow(tree)) {
+            return UINT32_MAX;
+        }
+        return intern(tree, node);
+    }
+    tree->nodes[tree->count] = *node;
+    tree->table[slot] = tree->count;
+    return tree->count++;
+}
+
+int createQuadTree(st_quadTree *tree) {
+    tree->capacity = 1 << 16;
+    tree->tableSize = 1 << 17;
+    tree->nodes = (st_quadNode *) malloc(tree->capacity * sizeof(st_quadNode));
+    tree->table = (uint32_t *) calloc(tree->tableSize, sizeof(uint32_t));
+    if (!tree->nodes || !tree->table) {
+        std::cout << "ERROR::QUAD_TREE::OUT_OF_MEMORY" << std::endl;
+        destroyQuadTree(tree);
+        return 0;
+    }
+    tree->nodes[0] = {};
+    tree->count = 1;
+    return 1;
+}
+
+void destroyQuadTree(st_quadTree *tree) {
+    free(tree->nodes);
+    free(tree->table);
+    tree->nodes = nullptr;
+    tree->table = nullptr;
+    tree->count = tree->capacity = tree->tableSize = 0;
+}
+
+uint32_t quadLeaf(st_quadTree *tree, uint64_t cells) {
+    if (!cells) {
+        return 0;
+    }
+    st_quadNode node = {cells, {}, QUAD_LEAF_LEVEL};
+    return intern(tree, &node);
+}
+
+uint32_t quadNode(st_quadTree *tree, int level, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    if (!(nw | ne | sw | se)) {
+        return 0;
+    }
+    st_quadNode node = {0, {nw, ne, sw, se}, level};
+    return intern(tree, &node);
+}
+
+static uint32_t fromBytes(st_quadTree *tree, const unsigned char *cells, int stride, int width, int height, int level,
+                          int x, int y) {
+    if (x >= width || y >= height) {
+        return 0;
+    }
+    if (level == QUAD_LEAF_LEVEL) {
+        uint64_t leaf = 0;
+        for (int j = 0; j < 8 && y + j < height; ++j) {
+            const unsigned char *row = cells + x + (long long) (y + j) * stride;
+            for (int i = 0; i < 8 && x + i < width; ++i) {
+                leaf |= (uint64_t) (row[i] == 1) << (8 * j + i);
+            }
+        }
+        return quadLeaf(tree, leaf);
+    }
+    int half = 1 << (level - 1);
+    uint32_t nw = fromBytes(tree, cells, stride, width, height, level - 1, x, y);
+    uint32_t ne = fromBytes(tree, cells, stride, width, height, level - 1, x + half, y);
+    uint32_t sw = fromBytes(tree, cells, stride, width, height, level - 1, x, y + half);
+    uint32_t se = fromBytes(tree, cells, stride, width, height, level - 1, x + half, y + half);
+    if (nw == UINT32_MAX || ne == UINT32_MAX || sw == UINT32_MAX || se == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+    return quadNode(tree, level, nw, ne, sw, se);
+}
+
+uint32_t quadFromBytes(st_quadTree *tree, const unsigned char *cells, int stride, int width, int height, int *level) {
+    *level = QUAD_LEAF_LEVEL;
+    while ((1 << *level) < width || (1 << *level) < height) {
+        ++*level;
+    }
+    return fromBytes(tree, cells, stride, width, height, *level, 0, 0);
+}
+
+static void findBounds(const st_quadTree *tree, uint32_t node, std::vector<std::array<long long, 4>> &memo) {
+    std::array<long long, 4> &box = memo[node];
+    if (box[0] >= 0) {
+        return;
+    }
+    const st_quadNode *n = tree->nodes + node;
+    box = {1ll << n->level, 1ll << n->level, 0, 0};
+    if (n->level == QUAD_LEAF_LEVEL) {
+        for (uint64_t leaf = n->leaf; leaf; leaf &= leaf - 1) {
+            int bit = __builtin_ctzll(leaf);
+            box = {std::min<long long>(box[0], bit & 7), std::min<long long>(box[1], bit >> 3),
+                   std::max<long long>(box[2], (bit & 7) + 1), std::max<long long>(box[3], (bit >> 3) + 1)};
+        }
+        return;
+    }
+    long long half = 1ll << (n->level - 1);
+    for (int i = 0; i < 4; ++i) {
+        uint32_t child = n->children[i];
+        if (!child) {
+            continue;
+        }
+        findBounds(tree, child, memo);
+        const std::array<long long, 4> &c = memo[child];
+        long long x = i & 1 ? half : 0, y = i & 2 ? half : 0;
+        box = {std::min(box[0], x + c[0]), std::min(box[1], y + c[1]), std::max(box[2], x + c[2]),
+               std::max(box[3], y + c[3])};
+    }
+}
+
+int quadBounds(const st_quadTree *tree, uint32_t node, long long bounds[4]) {
+    if (!node) {
+        return 0;
+    }
+    std::vector<std::array<long long, 4>> memo(tree->count, {-1, -1, -1, -1});
+    findBounds(tree, node, memo);
+    for (int i = 0; i < 4; ++i) {
+        bounds[i] = memo[node][i];
+    }
+    return 1;
+}
+
+// x and y are in cells relative to the top left cell of the view
+static void toBytes(const st_quadTree *tree, uint32_t node, int level, unsigned char *cells, int stride, int width,
+                    int height, long long x, long long y, int shift) {
+    long long last = (1ll << level) - 1;
+    if (!node || x >> shift >= width || y >> shift >= height || (x + last) >> shift < 0 || (y + last) >> shift < 0) {
+        return;
+    }
+    if (level <= shift) {
+        // the whole node falls into one byte
+        cells[(x >> shift) + (y >> shift) * stride] = 1;
+        return;
+    }
+    if (level == QUAD_LEAF_LEVEL) {
+        uint64_t leaf = tree->nodes[node].leaf;
+        for (; leaf; leaf &= leaf - 1) {
+            int bit = __builtin_ctzll(leaf);
+            long long i = (x + (bit & 7)) >> shift, j = (y + (bit >> 3)) >> shift;
+            if (i >= 0 && i < width && j >= 0 && j < height) {
+                cells[i + j * stride] = 1;
+            }
+        }
+        return;
+    }
+    const uint32_t *children = tree->nodes[node].children;
+    long long half = 1ll << (level - 1);
+    toBytes(tree, children[0], level - 1, cells, stride, width, height, x, y, shift);
+    toBytes(tree, children[1], level - 1, cells, stride, width, height, x + half, y, shift);
+    toBytes(tree, children[2], level - 1, cells, stride, width, height, x, y + half, shift);
+    toBytes(tree, children[3], level - 1, cells, stride, width, height, x + half, y + half, shift);
+}
+
+void quadToBytes(const st_quadTree *tree, uint32_t node, int level, unsigned char *cells, int stride, int width,
+                 int height, long long x, long long y, int shift) {
+    toBytes(tree, node, level, cells, stride, width, height, x * (1ll << shift), y * (1ll << shift), shift);
+}
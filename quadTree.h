@@ -0,0 +1,48 @@
+#ifndef CONWAY_LIFE_QUAD_TREE_H
+#define CONWAY_LIFE_QUAD_TREE_H
+
+#include <cstdint>
+
+// Hash-consed quadtree store, the node representation HashLife works on. A node of level k covers a 2^k square;
+// level 3 nodes are 8x8 leaves holding their cells in leaf, bit 8 * y + x. Every distinct node is stored exactly once,
+// so repeated structure costs nothing, and index 0 is the all dead node of every level.
+struct st_quadNode {
+    uint64_t leaf;
+    uint32_t children[4];  // nw, ne, sw, se
+    int level;
+};
+
+struct st_quadTree {
+    st_quadNode *nodes;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *table;  // open addressing over node indices, 0 is a free slot
+    uint32_t tableSize;
+};
+
+const int QUAD_LEAF_LEVEL = 3;
+const int QUAD_MAX_LEVEL = 60;
+
+int createQuadTree(st_quadTree *tree);
+
+void destroyQuadTree(st_quadTree *tree);
+
+// Return the index of the node with these contents, adding it when it is new. UINT32_MAX when out of memory.
+uint32_t quadLeaf(st_quadTree *tree, uint64_t cells);
+
+uint32_t quadNode(st_quadTree *tree, int level, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+
+// Builds the smallest tree covering width x height cells of one byte of state each, rows stride bytes apart.
+// Cells in state 1 are alive. Sets level to the level of the returned root.
+uint32_t quadFromBytes(st_quadTree *tree, const unsigned char *cells, int stride, int width, int height, int *level);
+
+// Bounding box [bounds[0], bounds[2]) x [bounds[1], bounds[3]) of the live cells of node, relative to its top left
+// corner. Visits every distinct node once. Returns 0 for the empty node.
+int quadBounds(const st_quadTree *tree, uint32_t node, long long bounds[4]);
+
+// Draws node at level into width x height bytes, its top left corner at (x, y) and one byte per 2^shift square.
+// A byte is set to 1 when its square has a live cell and left alone otherwise, so cells must start out dead.
+void quadToBytes(const st_quadTree *tree, uint32_t node, int level, unsigned char *cells, int stride, int width,
+                 int height, long long x, long long y, int shift);
+
+#endif
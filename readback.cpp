@@ -0,0 +1,95 @@
+#include "readback.h"
+
+#include <iostream>
+
+int createReadbackRing(st_readbackRing *ring, size_t slotSize) {
+    ring->slotSize = slotSize;
+    ring->head = ring->tail = ring->pending = 0;
+    for (auto &slot: ring->slots) {
+        slot.buffer = 0;
+        slot.data = nullptr;
+        slot.fence = nullptr;
+    }
+    const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    for (auto &slot: ring->slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, slot.buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr) slotSize, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+        slot.data = (const unsigned char *) glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr) slotSize, flags);
+        if (!slot.data) {
+            std::cout << "ERROR::READBACK::MAP_FAILED" << std::endl;
+            destroyReadbackRing(ring);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void destroyReadbackRing(st_readbackRing *ring) {
+    pollReadbacks(ring, true);
+    for (auto &slot: ring->slots) {
+        if (slot.data) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, slot.buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        if (slot.buffer) {
+            glDeleteBuffers(1, &slot.buffer);
+        }
+        slot.buffer = 0;
+        slot.data = nullptr;
+    }
+}
+
+int requestReadback(st_readbackRing *ring, unsigned int source, size_t offset, size_t size,
+                    readbackCallback callback) {
+    if (ring->pending == READBACK_SLOTS || size > ring->slotSize) {
+        return 0;
+    }
+    auto &slot = ring->slots[ring->head];
+    glBindBuffer(GL_COPY_READ_BUFFER, source);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, slot.buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr) offset, 0, (GLsizeiptr) size);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.callback = std::move(callback);
+    ring->head = (ring->head + 1) % READBACK_SLOTS;
+    ++ring->pending;
+    return 1;
+}
+
+int requestPixels(st_readbackRing *ring, int x, int y, int width, int height, readbackCallback callback) {
+    size_t size = (size_t) width * height * 4;
+    if (ring->pending == READBACK_SLOTS || size > ring->slotSize) {
+        return 0;
+    }
+    auto &slot = ring->slots[ring->head];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.callback = std::move(callback);
+    ring->head = (ring->head + 1) % READBACK_SLOTS;
+    ++ring->pending;
+    return 1;
+}
+
+void pollReadbacks(st_readbackRing *ring, bool wait) {
+    while (ring->pending) {
+        auto &slot = ring->slots[ring->tail];
+        // flush on the first wait so the fence is guaranteed to be reached
+        GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         wait ? GL_TIMEOUT_IGNORED : 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        // coherent mapping: the data is visible once the fence has signaled
+        slot.callback(slot.data, slot.size);
+        slot.callback = nullptr;
+        ring->tail = (ring->tail + 1) % READBACK_SLOTS;
+        --ring->pending;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef CONWAY_LIFE_READBACK_H
+#define CONWAY_LIFE_READBACK_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <functional>
+
+// Ring of persistently mapped buffers for reading GPU buffers back without stalling. A request copies on the GPU
+// into the next free slot and fences the copy; polling hands every slot whose fence has signaled to its callback, in
+// request order, while the GPU keeps running later generations. Needs OpenGL 4.4 for glBufferStorage.
+const int READBACK_SLOTS = 3;
+
+typedef std::function<void(const unsigned char *data, size_t size)> readbackCallback;
+
+struct st_readbackRing {
+    size_t slotSize;
+    int head;  // next slot to request into
+    int tail;  // oldest request still in flight
+    int pending;
+    struct {
+        unsigned int buffer;
+        const unsigned char *data;
+        GLsync fence;
+        size_t size;
+        readbackCallback callback;
+    } slots[READBACK_SLOTS];
+};
+
+int createReadbackRing(st_readbackRing *ring, size_t slotSize);
+
+// Waits for every request in flight and runs its callback first
+void destroyReadbackRing(st_readbackRing *ring);
+
+// Queues a copy of size bytes from offset in source. Returns 0 without blocking when every slot is in flight.
+int requestReadback(st_readbackRing *ring, unsigned int source, size_t offset, size_t size,
+                    readbackCallback callback);
+
+// Queues a glReadPixels of the bound read framebuffer as RGBA bytes, bottom row first. Same rules as above.
+int requestPixels(st_readbackRing *ring, int x, int y, int width, int height, readbackCallback callback);
+
+// Runs the callbacks of finished requests, with wait set blocks until every request has finished.
+// Data passed to a callback is only valid during the call.
+void pollReadbacks(st_readbackRing *ring, bool wait);
+
+#endif
@@ -0,0 +1,252 @@
+#include "recorder.h"
+
+#include <iostream>
+#include <cstring>
+
+static const char MAGIC[8] = {'C', 'O', 'N', 'W', 'A', 'Y', 'R', 'C'};
+static const char INDEX_MAGIC[8] = {'C', 'O', 'N', 'W', 'A', 'Y', 'I', 'X'};
+
+// equal bytes shorter than this stay inside a literal, a new token would cost more
+static const size_t MIN_RUN = 4;
+
+static uint64_t loadWord(const unsigned char *p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+static unsigned char *writeVarint(unsigned char *out, size_t value) {
+    while (value >= 0x80) {
+        *out++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char) value;
+    return out;
+}
+
+static const unsigned char *readVarint(const unsigned char *in, const unsigned char *end, size_t *value) {
+    *value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        unsigned char byte = *in++;
+        *value |= (size_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+void packFrame(unsigned char *frame, const st_recordingHeader *header, const unsigned char *cells, int stride) {
+    if (header->cellBits == 8) {
+        for (int y = 0; y < header->height; ++y) {
+            std::memcpy(frame + (size_t) y * header->width, cells + (long long) y * stride, header->width);
+        }
+        return;
+    }
+    // eight cells of 0 or 1 into one byte, cell i to bit i
+    const int rowBytes = (header->width + 7) / 8;
+    for (int y = 0; y < header->height; ++y) {
+        const unsigned char *row = cells + (long long) y * stride;
+        unsigned char *out = frame + (size_t) y * rowBytes;
+        int x = 0;
+        for (; x + 8 <= header->width; x += 8) {
+            *out++ = (unsigned char) ((loadWord(row + x) & 0x0101010101010101ull) * 0x0102040810204080ull >> 56);
+        }
+        if (x < header->width) {
+            unsigned char last = 0;
+            for (int i = 0; x + i < header->width; ++i) {
+                last |= (unsigned char) ((row[x + i] == 1) << i);
+            }
+            *out = last;
+        }
+    }
+}
+
+void unpackFrame(unsigned char *cells, int stride, const st_recordingHeader *header, const unsigned char *frame) {
+    if (header->cellBits == 8) {
+        for (int y = 0; y < header->height; ++y) {
+            std::memcpy(cells + (long long) y * stride, frame + (size_t) y * header->width, header->width);
+        }
+        return;
+    }
+    const int rowBytes = (header->width + 7) / 8;
+    for (int y = 0; y < header->height; ++y) {
+        unsigned char *row = cells + (long long) y * stride;
+        const unsigned char *in = frame + (size_t) y * rowBytes;
+        for (int x = 0; x < header->width; ++x) {
+            row[x] = (in[x >> 3] >> (x & 7)) & 1;
+        }
+    }
+}
+
+size_t encodeDelta(unsigned char *out, const unsigned char *frame, const unsigned char *previous, size_t size) {
+    unsigned char *o = out;
+    size_t pos = 0;
+    while (pos < size) {
+        // zero run of the difference, a word at a time
+        size_t start = pos;
+        while (pos + 8 <= size && loadWord(frame + pos) == loadWord(previous + pos)) {
+            pos += 8;
+        }
+        while (pos < size && frame[pos] == previous[pos]) {
+            ++pos;
+        }
+        size_t zeros = pos - start, literal = pos;
+
+        // literal up to the next zero run of at least MIN_RUN
+        while (pos < size) {
+            if (frame[pos] != previous[pos]) {
+                ++pos;
+                continue;
+            }
+            size_t run = pos;
+            while (run < size && run - pos < MIN_RUN && frame[run] == previous[run]) {
+                ++run;
+            }
+            if (run - pos >= MIN_RUN || run == size) {
+                break;
+            }
+            pos = run;
+        }
+
+        o = writeVarint(o, zeros);
+        o = writeVarint(o, pos - literal);
+        for (size_t i = literal; i < pos; ++i) {
+            *o++ = frame[i] ^ previous[i];
+        }
+    }
+    return o - out;
+}
+
+int applyDelta(unsigned char *frame, const unsigned char *delta, size_t deltaSize, size_t size) {
+    const unsigned char *in = delta, *end = delta + deltaSize;
+    size_t pos = 0;
+    while (in < end) {
+        size_t zeros, literal;
+        if (!(in = readVarint(in, end, &zeros)) || !(in = readVarint(in, end, &literal)) ||
+            zeros > size - pos || literal > size - pos - zeros || literal > (size_t) (end - in)) {
+            return 0;
+        }
+        pos += zeros;
+        for (size_t i = 0; i < literal; ++i) {
+            frame[pos + i] ^= in[i];
+        }
+        pos += literal;
+        in += literal;
+    }
+    return 1;
+}
+
+static void writeFrames(st_recorder *recorder) {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(recorder->mutex);
+        recorder->changed.wait(lock, [recorder] { return recorder->closing || !recorder->ready.empty(); });
+        if (recorder->ready.empty()) {
+            return;
+        }
+        int index = recorder->ready.front();
+        recorder->ready.pop_front();
+        lock.unlock();
+
+        std::vector<unsigned char> &frame = recorder->frames[index];
+        bool keyframe = recorder->frameCount++ % recorder->header.keyframeInterval == 0;
+        if (keyframe) {
+            recorder->keyframes.push_back(recorder->offset);
+        }
+        auto size = (uint32_t) encodeDelta(recorder->encoded.data(), frame.data(),
+                                           keyframe ? recorder->dead.data() : recorder->previous.data(), frame.size());
+        bool written = fwrite(&size, sizeof(size), 1, recorder->file) == 1 &&
+                       fwrite(recorder->encoded.data(), size, 1, recorder->file) == 1;
+        recorder->offset += sizeof(size) + size;
+        // the frame becomes the reference for the next one, the old reference goes back to the pool
+        std::swap(frame, recorder->previous);
+
+        lock.lock();
+        recorder->failed = recorder->failed || !written;
+        recorder->free.push_back(index);
+        recorder->changed.notify_all();
+    }
+}
+
+int openRecorder(st_recorder *recorder, const char *file, int width, int height, int states, const char *rule,
+                 long long generation, int keyframeInterval) {
+    st_recordingHeader &header = recorder->header;
+    header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = RECORDING_VERSION;
+    header.width = width;
+    header.height = height;
+    header.states = states;
+    header.cellBits = states == 2 ? 1 : 8;
+    header.frameSize = states == 2 ? (uint32_t) ((width + 7) / 8 * height) : (uint32_t) (width * height);
+    header.keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+    header.firstGeneration = generation;
+    std::strncpy(header.rule, rule, sizeof(header.rule) - 1);
+
+    recorder->file = fopen(file, "wb");
+    if (!recorder->file || fwrite(&header, sizeof(header), 1, recorder->file) != 1) {
+        std::cout << "ERROR::RECORDER::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        if (recorder->file) {
+            fclose(recorder->file);
+        }
+        recorder->file = nullptr;
+        return 0;
+    }
+
+    recorder->frames.assign(RECORDER_QUEUE, std::vector<unsigned char>(header.frameSize));
+    recorder->previous.assign(header.frameSize, 0);
+    recorder->encoded.resize(header.frameSize + 32);
+    recorder->dead.assign(header.frameSize, 0);
+    recorder->keyframes.clear();
+    recorder->frameCount = 0;
+    recorder->offset = sizeof(header);
+    recorder->ready.clear();
+    recorder->free.clear();
+    for (int i = 0; i < RECORDER_QUEUE; ++i) {
+        recorder->free.push_back(i);
+    }
+    recorder->closing = recorder->failed = false;
+    recorder->writer = std::thread(writeFrames, recorder);
+    return 1;
+}
+
+int recordFrame(st_recorder *recorder, const unsigned char *cells, int stride) {
+    std::unique_lock<std::mutex> lock(recorder->mutex);
+    recorder->changed.wait(lock, [recorder] { return !recorder->free.empty(); });
+    int index = recorder->free.front();
+    recorder->free.pop_front();
+    lock.unlock();
+
+    packFrame(recorder->frames[index].data(), &recorder->header, cells, stride);
+
+    lock.lock();
+    recorder->ready.push_back(index);
+    recorder->changed.notify_all();
+    return !recorder->failed;
+}
+
+int closeRecorder(st_recorder *recorder) {
+    if (!recorder->file) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(recorder->mutex);
+        recorder->closing = true;
+        recorder->changed.notify_all();
+    }
+    recorder->writer.join();
+
+    st_recordingTrailer trailer = {recorder->offset, recorder->keyframes.size(), recorder->frameCount, {}};
+    std::memcpy(trailer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    int success = !recorder->failed &&
+                  fwrite(recorder->keyframes.data(), sizeof(uint64_t), recorder->keyframes.size(), recorder->file) ==
+                  recorder->keyframes.size() && fwrite(&trailer, sizeof(trailer), 1, recorder->file) == 1;
+    success = fclose(recorder->file) == 0 && success;
+    recorder->file = nullptr;
+    if (!success) {
+        std::cout << "ERROR::RECORDER::WRITE_FAILED" << std::endl;
+    }
+    recorder->frames.clear();
+    return success;
+}
@@ -0,0 +1,81 @@
+#ifndef CONWAY_LIFE_RECORDER_H
+#define CONWAY_LIFE_RECORDER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Recording of consecutive generations. Every frame is packed (one bit per cell for two-state rules, one byte
+// otherwise, rows padded to whole bytes), XORed with the frame before it and the sparse difference is coded as
+// alternating zero runs and literal bytes, both lengths as LEB128 varints. Every keyframeInterval-th frame, starting
+// with the first, is a keyframe coded against an all dead frame, so any frame decodes from at most that many frames.
+const uint32_t RECORDING_VERSION = 2;
+
+struct st_recordingHeader {
+    char magic[8];  // "CONWAYRC"
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t states;
+    uint32_t cellBits;
+    uint32_t frameSize;
+    uint32_t keyframeInterval;
+    int64_t firstGeneration;
+    char rule[128];
+};
+
+// Every frame follows the header as a uint32_t coded size and the coded difference. Closing the recorder appends the
+// file offsets of all keyframes as uint64_t and this trailer. A recording cut short has no trailer but stays readable.
+struct st_recordingTrailer {
+    uint64_t indexOffset;
+    uint64_t keyframeCount;
+    uint64_t frameCount;
+    char magic[8];  // "CONWAYIX"
+};
+
+// Packing happens on the caller's thread, coding and writing on a background thread. At most RECORDER_QUEUE packed
+// frames wait for the writer; recordFrame blocks when the queue is full, so memory stays bounded.
+const int RECORDER_QUEUE = 64;
+
+struct st_recorder {
+    FILE *file;
+    st_recordingHeader header;
+    std::vector<std::vector<unsigned char>> frames;
+    std::deque<int> ready;  // packed frames waiting for the writer
+    std::deque<int> free;
+    std::vector<unsigned char> previous;
+    std::vector<unsigned char> encoded;
+    std::vector<unsigned char> dead;
+    std::vector<uint64_t> keyframes;
+    uint64_t frameCount;
+    uint64_t offset;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread writer;
+    bool closing;
+    bool failed;
+};
+
+int openRecorder(st_recorder *recorder, const char *file, int width, int height, int states, const char *rule,
+                 long long generation, int keyframeInterval);
+
+// Queues the next generation. cells points at cell (0, 0) of one byte of state per cell, rows stride bytes apart.
+int recordFrame(st_recorder *recorder, const unsigned char *cells, int stride);
+
+// Writes out every queued frame and the keyframe index and closes the file.
+int closeRecorder(st_recorder *recorder);
+
+// Frame coding, shared with the replay reader
+void packFrame(unsigned char *frame, const st_recordingHeader *header, const unsigned char *cells, int stride);
+
+void unpackFrame(unsigned char *cells, int stride, const st_recordingHeader *header, const unsigned char *frame);
+
+size_t encodeDelta(unsigned char *out, const unsigned char *frame, const unsigned char *previous, size_t size);
+
+int applyDelta(unsigned char *frame, const unsigned char *delta, size_t deltaSize, size_t size);
+
+#endif
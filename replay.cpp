@@ -0,0 +1,122 @@
+#include "replay.h"
+#include "mapping.h"
+
+#include <iostream>
+#include <cstring>
+
+static uint32_t frameSize(const st_replay *replay, uint64_t offset) {
+    uint32_t size;
+    std::memcpy(&size, replay->data + offset, sizeof(size));
+    return size;
+}
+
+// offsets of the keyframes and the frame count, from the index when the recording was closed properly
+static int readIndex(st_replay *replay) {
+    const st_recordingHeader &header = replay->header;
+    st_recordingTrailer trailer;
+    if (replay->size >= sizeof(header) + sizeof(trailer)) {
+        std::memcpy(&trailer, replay->data + replay->size - sizeof(trailer), sizeof(trailer));
+        uint64_t indexSize = trailer.keyframeCount * sizeof(uint64_t);
+        if (std::memcmp(trailer.magic, "CONWAYIX", 8) == 0 && trailer.indexOffset <= replay->size &&
+            trailer.keyframeCount <= replay->size / sizeof(uint64_t) &&
+            indexSize <= replay->size - sizeof(trailer) - trailer.indexOffset &&
+            trailer.keyframeCount == (trailer.frameCount + header.keyframeInterval - 1) / header.keyframeInterval) {
+            replay->keyframes.resize(trailer.keyframeCount);
+            std::memcpy(replay->keyframes.data(), replay->data + trailer.indexOffset, indexSize);
+            replay->frameCount = (long long) trailer.frameCount;
+            return 1;
+        }
+    }
+
+    // cut short: walk the frames, dropping a partly written last one
+    replay->keyframes.clear();
+    replay->frameCount = 0;
+    for (uint64_t offset = sizeof(header); offset + sizeof(uint32_t) <= replay->size;) {
+        uint64_t end = offset + sizeof(uint32_t) + frameSize(replay, offset);
+        if (end > replay->size) {
+            break;
+        }
+        if (replay->frameCount++ % header.keyframeInterval == 0) {
+            replay->keyframes.push_back(offset);
+        }
+        offset = end;
+    }
+    return 1;
+}
+
+int openReplay(st_replay *replay, const char *file) {
+    replay->mapping = mapFile(file, &replay->size);
+    replay->data = (const unsigned char *) replay->mapping;
+    if (!replay->mapping) {
+        std::cout << "ERROR::REPLAY::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        return 0;
+    }
+
+    st_recordingHeader &header = replay->header;
+    const char *error = nullptr;
+    if (replay->size < sizeof(header)) {
+        error = "NOT_A_RECORDING";
+    } else {
+        std::memcpy(&header, replay->data, sizeof(header));
+        if (std::memcmp(header.magic, "CONWAYRC", 8) != 0) {
+            error = "NOT_A_RECORDING";
+        } else if (header.version != RECORDING_VERSION) {
+            error = "UNSUPPORTED_VERSION";
+        } else if (header.keyframeInterval == 0 || header.width <= 0 || header.height <= 0 ||
+                   header.rule[sizeof(header.rule) - 1] != '\0') {
+            error = "CORRUPT";
+        }
+    }
+    if (error) {
+        std::cout << "ERROR::REPLAY::" << error << std::endl;
+        std::cout << file << std::endl;
+        closeReplay(replay);
+        return 0;
+    }
+
+    readIndex(replay);
+    replay->frame.assign(header.frameSize, 0);
+    replay->current = -1;
+    replay->next = 0;
+    return 1;
+}
+
+void closeReplay(st_replay *replay) {
+    if (replay->mapping) {
+        unmapFile(replay->mapping, replay->size);
+    }
+    replay->mapping = nullptr;
+    replay->data = nullptr;
+}
+
+long long seekReplay(st_replay *replay, long long index) {
+    if (replay->frameCount == 0) {
+        return -1;
+    }
+    index = index < 0 ? 0 : index >= replay->frameCount ? replay->frameCount - 1 : index;
+
+    const long long interval = replay->header.keyframeInterval, keyframe = index / interval * interval;
+    if (replay->current < keyframe || replay->current > index) {
+        replay->current = keyframe - 1;
+        replay->next = replay->keyframes[keyframe / interval];
+    }
+    while (replay->current < index) {
+        uint64_t offset = replay->next;
+        if (offset > replay->size - sizeof(uint32_t) ||
+            frameSize(replay, offset) > replay->size - offset - sizeof(uint32_t)) {
+            replay->current = -1;
+            return -1;
+        }
+        uint32_t size = frameSize(replay, offset);
+        if (++replay->current % interval == 0) {
+            std::memset(replay->frame.data(), 0, replay->frame.size());
+        }
+        if (!applyDelta(replay->frame.data(), replay->data + offset + sizeof(uint32_t), size, replay->frame.size())) {
+            replay->current = -1;
+            return -1;
+        }
+        replay->next = offset + sizeof(uint32_t) + size;
+    }
+    return replay->header.firstGeneration + index;
+}
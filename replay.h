@@ -0,0 +1,39 @@
+#ifndef CONWAY_LIFE_REPLAY_H
+#define CONWAY_LIFE_REPLAY_H
+
+#include "recorder.h"
+
+#include <cstdint>
+#include <vector>
+
+// Mapped recording with random access by frame. Seeking decodes forward from the current frame when that is on the
+// way, from the nearest keyframe before the target otherwise, so no seek decodes more than keyframeInterval frames.
+struct st_replay {
+    st_recordingHeader header;
+    const unsigned char *data;
+    size_t size;
+    void *mapping;
+    std::vector<uint64_t> keyframes;  // file offset of every keyframe
+    long long frameCount;
+    std::vector<unsigned char> frame;
+    long long current;  // frame held in frame, -1 before the first seek
+    uint64_t next;  // file offset of the frame after current
+};
+
+int openReplay(st_replay *replay, const char *file);
+
+void closeReplay(st_replay *replay);
+
+inline long long replayFrameCount(const st_replay *replay) {
+    return replay->frameCount;
+}
+
+// Decodes frame index, clamped to the recording. Returns the generation of the decoded frame, -1 on corrupt data.
+long long seekReplay(st_replay *replay, long long index);
+
+// Writes the current frame as one byte of state per cell, cells pointing at cell (0, 0) with rows stride bytes apart.
+inline void readReplay(const st_replay *replay, unsigned char *cells, int stride) {
+    unpackFrame(cells, stride, &replay->header, replay->frame.data());
+}
+
+#endif
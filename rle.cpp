@@ -0,0 +1,231 @@
+#include "rle.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+static const size_t CHUNK_SIZE = 1 << 20;
+
+static int fill(st_rleReader *reader) {
+    reader->length = fread(reader->buffer, 1, CHUNK_SIZE, reader->file);
+    reader->position = 0;
+    // sentinel, ends a scan of digits at the end of the chunk
+    reader->buffer[reader->length] = '\0';
+    return reader->length > 0;
+}
+
+static int nextChar(st_rleReader *reader) {
+    if (reader->position == reader->length && !fill(reader)) {
+        return EOF;
+    }
+    return (unsigned char) reader->buffer[reader->position++];
+}
+
+// just past the '=' that follows key, null when key or the '=' is missing
+static const char *headerValue(const char *line, const char *key) {
+    const char *at = std::strstr(line, key);
+    at = at ? std::strchr(at, '=') : nullptr;
+    return at ? at + 1 : nullptr;
+}
+
+// "x = 3, y = 3, rule = B3/S23", spaces optional
+static int parseHeader(st_rleReader *reader, const char *line) {
+    const char *x = headerValue(line, "x"), *y = headerValue(line, "y"), *rule = headerValue(line, "rule");
+    if (!x || !y || std::sscanf(x, "%d", &reader->width) != 1 || std::sscanf(y, "%d", &reader->height) != 1) {
+        return 0;
+    }
+    if (rule) {
+        std::sscanf(rule, " %127[^ ,\r\n]", reader->rule);
+    }
+    return reader->width >= 0 && reader->height >= 0;
+}
+
+int openRle(st_rleReader *reader, const char *file) {
+    reader->file = fopen(file, "rb");
+    reader->buffer = (char *) malloc(CHUNK_SIZE + 1);
+    reader->length = reader->position = 0;
+    reader->rule[0] = '\0';
+    if (!reader->file || !reader->buffer) {
+        std::cout << "ERROR::RLE::OPEN_FAILED" << std::endl;
+        std::cout << file << std::endl;
+        closeRle(reader);
+        return 0;
+    }
+
+    // skip comment lines up to the header
+    char line[512];
+    for (;;) {
+        int length = 0, c;
+        while ((c = nextChar(reader)) != EOF && c != '\n') {
+            if (length < (int) sizeof(line) - 1) {
+                line[length++] = (char) c;
+            }
+        }
+        line[length] = '\0';
+        if (line[0] != '#' && std::strchr(line, '=')) {
+            if (parseHeader(reader, line)) {
+                return 1;
+            }
+            break;
+        }
+        if (c == EOF) {
+            break;
+        }
+    }
+
+    std::cout << "ERROR::RLE::HEADER_MISSING" << std::endl;
+    std::cout << file << std::endl;
+    closeRle(reader);
+    return 0;
+}
+
+void closeRle(st_rleReader *reader) {
+    if (reader->file) {
+        fclose(reader->file);
+    }
+    free(reader->buffer);
+    reader->file = nullptr;
+    reader->buffer = nullptr;
+}
+
+// Classes of the run tags. Two-state runs are written without branching on their state, everything else is rare
+// enough to go through a switch.
+enum {
+    RLE_DEAD,
+    RLE_ALIVE,
+    RLE_OTHER
+};
+
+static const struct st_rleClasses {
+    unsigned char of[256];
+
+    constexpr st_rleClasses() : of() {
+        for (int c = 0; c < 256; ++c) {
+            of[c] = c == 'b' || c == '.' ? RLE_DEAD : c == 'o' ? RLE_ALIVE : RLE_OTHER;
+        }
+    }
+} RLE_CLASSES;
+
+// longer runs cannot fit a board and would overflow the count
+static const long long MAX_RUN = 0x7FFFFFFF;
+
+// Decodes runs and hands them to writeSpan(x, y, length, state), already clipped to [0, width) x [0, height).
+// Two-state runs inside the target are handed over dead or alive, so that the writer fills them without a branch on
+// the state; runs in any other state only when they are live.
+template<typename SpanWriter>
+static int decode(st_rleReader *reader, int width, int height, int x0, int y0, SpanWriter writeSpan) {
+    long long x = x0, y = y0, count = 0;
+    int prefix = 0;
+    for (;;) {
+        // a run at a time, the digits of its count scanned up to the sentinel past the chunk without bounds checks
+        const char *c = reader->buffer + reader->position, *end = reader->buffer + reader->length;
+        while (c < end) {
+            unsigned int digit;
+            while ((digit = (unsigned char) *c - '0') < 10) {
+                count = count * 10 + digit;
+                if (count > MAX_RUN) {
+                    std::cout << "ERROR::RLE::RUN_TOO_LONG" << std::endl;
+                    return 0;
+                }
+                ++c;
+            }
+            if (c == end) {
+                // the count goes on in the next chunk
+                break;
+            }
+            const long long run = count ? count : 1;
+            count = 0;
+            const char tag = *c++;
+
+            const int kind = RLE_CLASSES.of[(unsigned char) tag];
+            if (kind != RLE_OTHER) {
+                if (x >= 0 && x + run <= width && y >= 0 && y < height) {
+                    writeSpan((int) x, (int) y, (int) run, kind);
+                } else {
+                    long long begin = x < 0 ? 0 : x, stop = x + run > width ? width : x + run;
+                    if (kind == RLE_ALIVE && y >= 0 && y < height && begin < stop) {
+                        writeSpan((int) begin, (int) y, (int) (stop - begin), 1);
+                    }
+                }
+                x += run;
+                continue;
+            }
+
+            int state;
+            switch (tag) {
+                case '$':
+                    y += run;
+                    x = x0;
+                    continue;
+                case '!':
+                    reader->position = c - reader->buffer;
+                    return 1;
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                    continue;
+                default:
+                    if (tag >= 'A' && tag <= 'X') {
+                        state = prefix * 24 + (tag - 'A' + 1);
+                        prefix = 0;
+                        if (state > 255) {
+                            std::cout << "ERROR::RLE::STATE_OUT_OF_RANGE" << std::endl;
+                            return 0;
+                        }
+                        break;
+                    } else if (tag >= 'p' && tag <= 'y') {
+                        // the count is the run of the state the prefix starts
+                        prefix = tag - 'p' + 1;
+                        count = run > 1 ? run : 0;
+                        continue;
+                    }
+                    std::cout << "ERROR::RLE::UNEXPECTED_CHARACTER::" << tag << std::endl;
+                    return 0;
+            }
+
+            long long begin = x < 0 ? 0 : x, stop = x + run > width ? width : x + run;
+            if (y >= 0 && y < height && begin < stop) {
+                writeSpan((int) begin, (int) y, (int) (stop - begin), state);
+            }
+            x += run;
+        }
+        reader->position = reader->length;
+        if (!fill(reader)) {
+            // a missing '!' is tolerated at the end of the file
+            return 1;
+        }
+    }
+}
+
+int readRleToBoard(st_rleReader *reader, st_lifeBoard *board, int x, int y) {
+    return decode(reader, board->width, board->height, x, y, [board](int column, int row, int length, int state) {
+        if (state > 1) {
+            for (int i = 0; i < length; ++i) {
+                setCell(board, column + i, row, state);
+            }
+            return;
+        }
+        // whole words at a time, dead runs OR in nothing. The word after the run is always inside the board memory,
+        // at worst the first of the next row, and only gets bits of the run.
+        const uint64_t live = 0 - (uint64_t) state;
+        const int shift = column & 63;
+        uint64_t *word = lifeRow(board, row) + (column >> 6);
+        for (; length > 64; length -= 64, ++word) {
+            word[0] |= live << shift;
+            word[1] |= shift ? live >> (64 - shift) : 0;
+        }
+        const uint64_t bits = live & (length == 64 ? ~0ull : (1ull << length) - 1);
+        word[0] |= bits << shift;
+        word[1] |= shift ? bits >> (64 - shift) : 0;
+    });
+}
+
+int readRleToBytes(st_rleReader *reader, unsigned char *cells, int stride, int width, int height, int x, int y) {
+    return decode(reader, width, height, x, y, [cells, stride](int column, int row, int length, int state) {
+        if (state) {
+            std::memset(cells + column + (long long) row * stride, state, length);
+        }
+    });
+}
@@ -0,0 +1,32 @@
+#ifndef CONWAY_LIFE_RLE_H
+#define CONWAY_LIFE_RLE_H
+
+#include "cpuLife.h"
+
+#include <cstdio>
+
+// Streaming reader for RLE patterns. openRle reads the header, one of the read functions then decodes the data in
+// fixed-size chunks and writes every run straight into the target, so memory stays constant for any pattern size.
+// Targets must start out dead: dead runs are skipped, not written.
+struct st_rleReader {
+    FILE *file;
+    int width;
+    int height;
+    char rule[128];  // empty when the header has no rule
+    char *buffer;
+    size_t length;
+    size_t position;
+};
+
+int openRle(st_rleReader *reader, const char *file);
+
+void closeRle(st_rleReader *reader);
+
+// Decodes into a packed board with the pattern's top left corner at (x, y). Cells outside the board are dropped.
+int readRleToBoard(st_rleReader *reader, st_lifeBoard *board, int x, int y);
+
+// Decodes into one byte of state per cell, e.g. a mapped GPU board. cells points at cell (0, 0), rows are stride
+// bytes apart.
+int readRleToBytes(st_rleReader *reader, unsigned char *cells, int stride, int width, int height, int x, int y);
+
+#endif
@@ -0,0 +1,63 @@
+#include "rle.h"
+#include "testReport.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// Reads small RLE patterns through openRle and readRleToBytes and compares the cells with the states they spell.
+// The exit code tells whether every one matched.
+
+const char *const FILE_NAME = "rleTest.rle";
+
+struct st_rleCase {
+    const char *rle;
+    std::vector<int> cells;  // row after row, width taken from the header
+};
+
+// cells of the pattern, empty when it does not read
+static std::vector<int> readCells(const char *rle, int *width) {
+    FILE *file = fopen(FILE_NAME, "wb");
+    if (!file) {
+        return {};
+    }
+    fputs(rle, file);
+    fclose(file);
+
+    st_rleReader reader;
+    if (!openRle(&reader, FILE_NAME)) {
+        return {};
+    }
+    *width = reader.width;
+    std::vector<unsigned char> bytes((size_t) reader.width * reader.height);
+    const int read = readRleToBytes(&reader, bytes.data(), reader.width, reader.width, reader.height, 0, 0);
+    closeRle(&reader);
+    remove(FILE_NAME);
+    return read ? std::vector<int>(bytes.begin(), bytes.end()) : std::vector<int>();
+}
+
+int main() {
+    const st_rleCase cases[] = {
+            {"x = 3, y = 3, rule = B3/S23\nbo$2bo$3o!\n", {0, 1, 0, 0, 0, 1, 1, 1, 1}},
+            {"x = 4, y = 2, rule = B2/S/C3\n2AB$bBA!\n", {1, 1, 2, 0, 0, 2, 1, 0}},
+            // run counts in front of multi-state prefixes
+            {"x = 6, y = 1, rule = B2/S/C30\n3pA3B!\n", {25, 25, 25, 2, 2, 2}},
+            {"x = 5, y = 2, rule = B2/S/C250\npX2qB$3.2yA!\n", {48, 50, 50, 0, 0, 0, 0, 0, 241, 241}},
+    };
+
+    int failures = 0;
+    for (const st_rleCase &test : cases) {
+        int width = 0;
+        const std::vector<int> cells = readCells(test.rle, &width);
+        const bool same = cells == test.cells;
+        std::cout << test.rle << (same ? "matches" : "does not match") << std::endl;
+        if (!same) {
+            for (int i = 0; i < (int) cells.size(); ++i) {
+                std::cout << cells[i] << ((i + 1) % width ? " " : "\n");
+            }
+        }
+        failures += !same;
+    }
+
+    return reportTest("RLE", failures);
+}
@@ -0,0 +1,499 @@
+#include "rule.h"
+
+#include <iostream>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <algorithm>
+
+// Hensel letters per neighbor count and one representative shape for each (9-bit neighborhood, center bit 4).
+// Counts 5 to 8 use the complements of the shapes of 3 to 0.
+static const char *const HENSEL_LETTERS[9] = {"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz",
+                                              "ceaiknjqry", "ceaikn", "ce", ""};
+static const int HENSEL_SHAPES[5][13] = {
+        {0},
+        {1, 2},
+        {5, 10, 3, 40, 33, 68},
+        {69, 42, 11, 7, 98, 13, 14, 70, 41, 97},
+        {325, 170, 15, 45, 99, 71, 106, 102, 43, 101, 105, 78, 108}
+};
+
+static const int NEIGHBORS = 0x1EF;
+static const int ISOTROPIC_ORDER_TRIALS = 64;
+
+// position of the neighbors NW, N, NE, W, E, SW, S, SE in a 9-bit neighborhood
+static const int NEIGHBOR_BITS[8] = {0, 1, 2, 3, 5, 6, 7, 8};
+
+static int popcount9(int n) {
+    int count = 0;
+    for (; n; n &= n - 1) {
+        ++count;
+    }
+    return count;
+}
+
+// rotation by 90 degrees (t & 3 times) and reflection (t & 4) of a 3x3 neighborhood
+static int transformNeighborhood(int n, int t) {
+    int result = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (n & (1 << i)) {
+            int r = i / 3, c = i % 3;
+            for (int k = 0; k < (t & 3); ++k) {
+                int tmp = r;
+                r = c;
+                c = 2 - tmp;
+            }
+            if (t & 4) {
+                c = 2 - c;
+            }
+            result |= 1 << (r * 3 + c);
+        }
+    }
+    return result;
+}
+
+// index of the Hensel letter of every 9-bit neighborhood within HENSEL_LETTERS[count]
+static const signed char *henselLetterIndex() {
+    static signed char index[512];
+    static bool initialized = [] {
+        for (int count = 0; count <= 8; ++count) {
+            int letters = (int) std::strlen(HENSEL_LETTERS[count]);
+            for (int l = 0; l < (letters ? letters : 1); ++l) {
+                int shape = count <= 4 ? HENSEL_SHAPES[count][l] : NEIGHBORS & ~HENSEL_SHAPES[8 - count][l];
+                for (int t = 0; t < 8; ++t) {
+                    int n = transformNeighborhood(shape, t);
+                    index[n] = index[n | 16] = (signed char) l;
+                }
+            }
+        }
+        return true;
+    }();
+    (void) initialized;
+    return index;
+}
+
+static int parseStates(int *states, const char **c) {
+    int n = 0;
+    if (!std::isdigit(**c)) {
+        return 0;
+    }
+    while (std::isdigit(**c) && n <= 256) {
+        n = n * 10 + *(*c)++ - '0';
+    }
+    *states = n;
+    return n >= 2 && n <= 256;
+}
+
+// counts with optional Hensel letters; shapes collects the included 9-bit neighborhoods with the center clear
+static int parseCounts(unsigned int *mask, unsigned int *shapes, int *isotropic, const char **c) {
+    const signed char *letterIndex = henselLetterIndex();
+    *mask = 0;
+    while (std::isdigit(**c)) {
+        int n = *(*c)++ - '0';
+        if (n > 8) {
+            return 0;
+        }
+
+        int negate = **c == '-';
+        if (negate) {
+            ++*c;
+        }
+        unsigned int letters = 0;
+        while (std::islower(**c)) {
+            const char *letter = std::strchr(HENSEL_LETTERS[n], **c);
+            if (!letter) {
+                return 0;
+            }
+            letters |= 1u << (letter - HENSEL_LETTERS[n]);
+            ++*c;
+        }
+        if (negate && !letters) {
+            return 0;
+        }
+        if (!letters) {
+            *mask |= 1u << n;
+        } else {
+            *isotropic = 1;
+        }
+
+        for (int i = 0; i < 512; ++i) {
+            if (!(i & 16) && popcount9(i) == n &&
+                (!letters || (((letters >> letterIndex[i]) & 1) != (unsigned int) negate))) {
+                shapes[i >> 5] |= 1u << (i & 31);
+            }
+        }
+    }
+    return 1;
+}
+
+// comma separated neighbor sums of a weighted rule, e.g. "3,5,6"
+static int parseSums(unsigned int *mask, const char **c) {
+    *mask = 0;
+    while (std::isdigit(**c)) {
+        int n = 0;
+        while (std::isdigit(**c) && n < 32) {
+            n = n * 10 + *(*c)++ - '0';
+        }
+        if (n > 31) {
+            return 0;
+        }
+        *mask |= 1u << n;
+        if (**c == ',') {
+            ++*c;
+        }
+    }
+    return 1;
+}
+
+static int parseNeighborhood(int *neighborhood, const char **c) {
+    if (**c == 'H' || **c == 'V') {
+        if (*neighborhood != NEIGHBORHOOD_MOORE) {
+            return 0;
+        }
+        *neighborhood = *(*c)++ == 'H' ? NEIGHBORHOOD_HEXAGONAL : NEIGHBORHOOD_VON_NEUMANN;
+    }
+    return 1;
+}
+
+static int parseWeights(int *weights, const char **c) {
+    int total = 0;
+    for (int k = 0; k < 8; ++k) {
+        if (!std::isdigit(**c)) {
+            return 0;
+        }
+        weights[k] = *(*c)++ - '0';
+        total += weights[k];
+    }
+    return total <= 31;
+}
+
+int parseRule(st_rule *rule, const char *rulestring) {
+    const char *c = rulestring;
+    unsigned int birth = 0, survive = 0, birthShapes[16] = {}, surviveShapes[16] = {};
+    int states = 2, isotropic = 0, neighborhood = NEIGHBORHOOD_MOORE, success = 1, seenBirth = 0, seenSurvive = 0;
+    int weights[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    const bool weighted = std::strstr(rulestring, "/W") != nullptr;
+
+    if (std::isdigit(*c) || *c == '/') {
+        // legacy S/B and S/B/C notation, e.g. "23/3" or "345/2/4"
+        success = parseCounts(&survive, surviveShapes, &isotropic, &c) && *c++ == '/' &&
+                  parseCounts(&birth, birthShapes, &isotropic, &c) && parseNeighborhood(&neighborhood, &c);
+        if (success && *c == '/' && std::isdigit(c[1])) {
+            ++c;
+            success = parseStates(&states, &c);
+        }
+        seenBirth = seenSurvive = success;
+    } else {
+        for (int part = 0; success && part < 2; ++part) {
+            char letter = (char) std::toupper(*c++);
+            if (letter == 'B' && !seenBirth) {
+                success = weighted ? parseSums(&birth, &c) : parseCounts(&birth, birthShapes, &isotropic, &c);
+                seenBirth = 1;
+            } else if (letter == 'S' && !seenSurvive) {
+                success = weighted ? parseSums(&survive, &c) : parseCounts(&survive, surviveShapes, &isotropic, &c);
+                seenSurvive = 1;
+            } else {
+                success = 0;
+            }
+            success = success && parseNeighborhood(&neighborhood, &c);
+            if (part == 0 && *c == '/') {
+                ++c;
+            }
+        }
+        if (success && *c == '/' && (std::toupper(c[1]) == 'C' || std::toupper(c[1]) == 'G')) {
+            c += 2;
+            success = parseStates(&states, &c);
+        }
+        if (success && weighted) {
+            success = neighborhood == NEIGHBORHOOD_MOORE && *c++ == '/' && *c++ == 'W' && parseWeights(weights, &c);
+            neighborhood = NEIGHBORHOOD_WEIGHTED;
+        }
+    }
+
+    if (!success || !seenBirth || !seenSurvive || *c != '\0' || (isotropic && neighborhood != NEIGHBORHOOD_MOORE)) {
+        std::cout << "ERROR::RULE::PARSE_FAILED" << std::endl;
+        std::cout << rulestring << std::endl;
+        return 0;
+    }
+
+    if (neighborhood == NEIGHBORHOOD_HEXAGONAL) {
+        // hexagonal grid sheared onto the square one: the NE and SW corners are not neighbors
+        weights[2] = weights[5] = 0;
+    } else if (neighborhood == NEIGHBORHOOD_VON_NEUMANN) {
+        weights[0] = weights[2] = weights[5] = weights[7] = 0;
+    }
+
+    rule->birth = birth;
+    rule->survive = survive;
+    rule->states = states;
+    rule->isotropic = isotropic;
+    rule->neighborhood = neighborhood;
+    for (int k = 0; k < 8; ++k) {
+        rule->weights[k] = weights[k];
+    }
+    for (int i = 0; i < 16; ++i) {
+        rule->table[i] = 0;
+    }
+    for (int i = 0; i < 512; ++i) {
+        int alive;
+        if (isotropic) {
+            const unsigned int *shapes = i & 16 ? surviveShapes : birthShapes;
+            int shape = i & ~16;
+            alive = (int) (shapes[shape >> 5] >> (shape & 31)) & 1;
+        } else {
+            int sum = 0;
+            for (int k = 0; k < 8; ++k) {
+                sum += (i >> NEIGHBOR_BITS[k]) & 1 ? weights[k] : 0;
+            }
+            alive = (int) ((i & 16 ? survive : birth) >> sum) & 1;
+        }
+        if (alive) {
+            rule->table[i >> 5] |= 1u << (i & 31);
+        }
+    }
+    return 1;
+}
+
+static int parseNumber(int *n, const char **c) {
+    if (!std::isdigit(**c)) {
+        return 0;
+    }
+    *n = 0;
+    while (std::isdigit(**c) && *n < 1000000) {
+        *n = *n * 10 + *(*c)++ - '0';
+    }
+    return 1;
+}
+
+static int parseRange(int *min, int *max, const char **c) {
+    return parseNumber(min, c) && *(*c)++ == '.' && *(*c)++ == '.' && parseNumber(max, c) && *min <= *max;
+}
+
+int parseLtlRule(st_ltlRule *rule, const char *rulestring) {
+    const char *c = rulestring;
+    st_ltlRule parsed = {};
+    int success = *c++ == 'R' && parseNumber(&parsed.range, &c) && parsed.range >= 1 && parsed.range <= 250;
+    success = success && *c++ == ',' && *c++ == 'C' && parseNumber(&parsed.states, &c) && parsed.states <= 256;
+    success = success && *c++ == ',' && *c++ == 'M' && parseNumber(&parsed.middle, &c) && parsed.middle <= 1;
+    success = success && *c++ == ',' && *c++ == 'S' && parseRange(&parsed.surviveMin, &parsed.surviveMax, &c);
+    success = success && *c++ == ',' && *c++ == 'B' && parseRange(&parsed.birthMin, &parsed.birthMax, &c);
+    if (success && *c == ',') {
+        // only the Moore neighborhood is a box the running sums can count
+        success = *++c == 'N' && *++c == 'M' && *++c == '\0';
+    }
+
+    if (!success || *c != '\0') {
+        std::cout << "ERROR::RULE::PARSE_FAILED" << std::endl;
+        std::cout << rulestring << std::endl;
+        return 0;
+    }
+
+    // C0 and C1 both mean two states
+    if (parsed.states < 2) {
+        parsed.states = 2;
+    }
+    *rule = parsed;
+    return 1;
+}
+
+void formatLtlRule(char *out, int size, const st_ltlRule *rule) {
+    std::snprintf(out, size, "R%d,C%d,M%d,S%d..%d,B%d..%d,NM", rule->range, rule->states, rule->middle,
+                  rule->surviveMin, rule->surviveMax, rule->birthMin, rule->birthMax);
+}
+
+// appends the counts (and Hensel letters) of the neighborhoods alive with the given center
+static int formatCounts(char *out, const st_rule *rule, int center) {
+    const signed char *letterIndex = henselLetterIndex();
+    int length = 0;
+    for (int n = 0; n <= 8; ++n) {
+        int letters = (int) std::strlen(HENSEL_LETTERS[n]);
+        unsigned int included = 0, all = letters ? (1u << letters) - 1 : 1;
+        for (int i = 0; i < 512; ++i) {
+            if (((i >> 4) & 1) == center && popcount9(i & NEIGHBORS) == n && ((rule->table[i >> 5] >> (i & 31)) & 1)) {
+                included |= 1u << letterIndex[i];
+            }
+        }
+        if (!included) {
+            continue;
+        }
+        out[length++] = (char) ('0' + n);
+        if (included != all) {
+            int count = popcount9((int) included);
+            unsigned int written = count <= letters - count ? included : all & ~included;
+            if (written != included) {
+                out[length++] = '-';
+            }
+            for (int l = 0; l < letters; ++l) {
+                if ((written >> l) & 1) {
+                    out[length++] = HENSEL_LETTERS[n][l];
+                }
+            }
+        }
+    }
+    out[length] = '\0';
+    return length;
+}
+
+static void formatDigits(char *out, unsigned int mask) {
+    int length = 0;
+    for (int n = 0; n <= 8; ++n) {
+        if ((mask >> n) & 1) {
+            out[length++] = (char) ('0' + n);
+        }
+    }
+    out[length] = '\0';
+}
+
+static void formatSums(char *out, int size, unsigned int mask) {
+    int length = 0;
+    out[0] = '\0';
+    for (int n = 0; n < 32 && length < size; ++n) {
+        if ((mask >> n) & 1) {
+            length += std::snprintf(out + length, size - length, length ? ",%d" : "%d", n);
+        }
+    }
+}
+
+void formatRule(char *out, int size, const st_rule *rule) {
+    char b[128], s[128], states[16] = "", suffix[16] = "";
+    if (rule->neighborhood == NEIGHBORHOOD_WEIGHTED) {
+        formatSums(b, sizeof(b), rule->birth);
+        formatSums(s, sizeof(s), rule->survive);
+        std::snprintf(suffix, sizeof(suffix), "/W%d%d%d%d%d%d%d%d", rule->weights[0], rule->weights[1],
+                      rule->weights[2], rule->weights[3], rule->weights[4], rule->weights[5], rule->weights[6],
+                      rule->weights[7]);
+    } else if (rule->isotropic) {
+        formatCounts(b, rule, 0);
+        formatCounts(s, rule, 1);
+    } else {
+        formatDigits(b, rule->birth);
+        formatDigits(s, rule->survive);
+    }
+    if (rule->states > 2) {
+        std::snprintf(states, sizeof(states), "/C%d", rule->states);
+    }
+    const char *neighborhood = rule->neighborhood == NEIGHBORHOOD_HEXAGONAL ? "H" :
+                               rule->neighborhood == NEIGHBORHOOD_VON_NEUMANN ? "V" : "";
+    std::snprintf(out, size, "B%s/S%s%s%s%s", b, s, neighborhood, states, suffix);
+}
+
+void compileRule(st_ruleCircuit *circuit, const st_rule *rule) {
+    circuit->neighborhood = rule->neighborhood;
+    circuit->sumBits = 1;
+    int total = 0;
+    for (int k = 0; k < 8; ++k) {
+        circuit->weights[k] = rule->weights[k];
+        total += rule->weights[k];
+    }
+    while (total >> circuit->sumBits) {
+        ++circuit->sumBits;
+    }
+
+    circuit->termCount = 0;
+    for (int n = 0; n <= total; ++n) {
+        int when = ((rule->birth >> n) & 1 ? st_ruleCircuit::DEAD : 0) |
+                   ((rule->survive >> n) & 1 ? st_ruleCircuit::ALIVE : 0);
+        if (when) {
+            circuit->terms[circuit->termCount].count = n;
+            circuit->terms[circuit->termCount].when = when;
+            ++circuit->termCount;
+        }
+    }
+}
+
+// Subproblems are truth tables over the neighbors order[depth ..], bit j of the index for order[depth + j], with -1
+// where any value will do. Identical subproblems and identical nodes are only built once.
+struct st_diagramBuilder {
+    const int *order;
+    st_isotropicTable *table;
+    std::map<std::vector<signed char>, int> subproblems;
+    std::map<std::tuple<int, int, int>, int> nodes;
+};
+
+static int buildDiagram(st_diagramBuilder *builder, int depth, const std::vector<signed char> &values) {
+    // a constant wherever every neighborhood that matters agrees
+    int seen = 0;
+    for (signed char value : values) {
+        seen |= value >= 0 ? 1 << value : 0;
+    }
+    if (seen != 3) {
+        return seen == 2 ? 1 : 0;
+    }
+    auto found = builder->subproblems.find(values);
+    if (found != builder->subproblems.end()) {
+        return found->second;
+    }
+
+    // the neighbor is only tested when the two halves disagree somewhere both matter
+    const size_t half = values.size() / 2;
+    std::vector<signed char> low(half), high(half);
+    bool compatible = true;
+    for (size_t i = 0; i < half; ++i) {
+        low[i] = values[2 * i];
+        high[i] = values[2 * i + 1];
+        compatible = compatible && (low[i] < 0 || high[i] < 0 || low[i] == high[i]);
+    }
+    int result;
+    if (compatible) {
+        for (size_t i = 0; i < half; ++i) {
+            low[i] = low[i] >= 0 ? low[i] : high[i];
+        }
+        result = buildDiagram(builder, depth + 1, low);
+    } else {
+        const int lowValue = buildDiagram(builder, depth + 1, low);
+        const int highValue = buildDiagram(builder, depth + 1, high);
+        auto [node, added] = builder->nodes.try_emplace({builder->order[depth], lowValue, highValue},
+                                                        builder->table->nodeCount + 2);
+        if (added) {
+            builder->table->nodes[builder->table->nodeCount++] = {builder->order[depth], lowValue, highValue};
+        }
+        result = node->second;
+    }
+    builder->subproblems[values] = result;
+    return result;
+}
+
+// the diagrams of every count, testing the neighbors in order
+static void buildDiagrams(st_isotropicTable *table, const st_rule *rule, const int *order) {
+    st_diagramBuilder builder = {order, table, {}, {}};
+    table->nodeCount = 0;
+    for (int center = 0; center < 2; ++center) {
+        for (int n = 0; n <= 8; ++n) {
+            std::vector<signed char> values(256);
+            for (int i = 0; i < 256; ++i) {
+                int neighborhood = center << 4;
+                for (int j = 0; j < 8; ++j) {
+                    neighborhood |= (i >> j) & 1 ? 1 << order[j] : 0;
+                }
+                values[i] = popcount9(neighborhood & NEIGHBORS) == n
+                                    ? (signed char) ((rule->table[neighborhood >> 5] >> (neighborhood & 31)) & 1) : -1;
+            }
+            table->roots[n][center] = buildDiagram(&builder, 0, values);
+        }
+    }
+}
+
+void compileIsotropic(st_isotropicTable *table, const st_rule *rule) {
+    // the size of the diagrams depends on the order of the neighbors, a few shuffles find a small one
+    int order[8], bestOrder[8], bestNodes = -1;
+    uint32_t random = 1;
+    for (int trial = 0; trial < ISOTROPIC_ORDER_TRIALS; ++trial) {
+        for (int j = 0; j < 8; ++j) {
+            order[j] = NEIGHBOR_BITS[j];
+        }
+        for (int j = 7; j > 0 && trial > 0; --j) {
+            random = random * 1664525u + 1013904223u;
+            std::swap(order[j], order[(random >> 16) % (j + 1)]);
+        }
+        buildDiagrams(table, rule, order);
+        if (bestNodes < 0 || table->nodeCount < bestNodes) {
+            bestNodes = table->nodeCount;
+            std::copy(order, order + 8, bestOrder);
+        }
+    }
+    buildDiagrams(table, rule, bestOrder);
+}
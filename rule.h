@@ -0,0 +1,86 @@
+#ifndef CONWAY_LIFE_RULE_H
+#define CONWAY_LIFE_RULE_H
+
+// Life-like rule in B/S notation, e.g. "B3/S23" (Conway), "B36/S23" (HighLife), "B3678/S34678" (Day & Night).
+// Bit n of birth/survive is set when a dead/live cell with n live neighbors is alive in the next generation.
+// Generations rules add a state count, e.g. "B2/S/C3" (Brian's Brain): state 0 is dead, 1 is alive and a live cell
+// that does not survive decays through states 2 .. states - 1 before it is dead again. Only state 1 counts as a
+// neighbor and only state 0 can be born.
+// Isotropic non-totalistic rules use Hensel notation, e.g. "B2-a/S12": letters after a count select (or with '-'
+// exclude) neighborhood shapes with that count. Every rule is also compiled into table, bit i of which is set when the
+// 3x3 neighborhood i (bit 0 NW, 1 N, 2 NE, 3 W, 4 center, 5 E, 6 SW, 7 S, 8 SE) is alive in the next generation;
+// birth/survive then only hold the counts whose shapes are all included.
+// A neighborhood suffix selects hexagonal ("B2/S34H") or von Neumann ("B1/S1V") neighbors. Weighted rules give every
+// neighbor (NW, N, NE, W, E, SW, S, SE) a weight and list neighbor sums up to 31, e.g. "B3,5/S2,3,4/W21212121".
+enum {
+    NEIGHBORHOOD_MOORE,
+    NEIGHBORHOOD_HEXAGONAL,
+    NEIGHBORHOOD_VON_NEUMANN,
+    NEIGHBORHOOD_WEIGHTED
+};
+
+struct st_rule {
+    unsigned int birth;
+    unsigned int survive;
+    int states;
+    int isotropic;
+    int neighborhood;
+    int weights[8];
+    unsigned int table[16];
+};
+
+// Boolean circuit compiled from a rule for the bit-sliced CPU kernels: one product term over the sumBits bit-planes of
+// the neighbor count for every count that leads to a live cell, restricted to dead cells, live cells or both.
+struct st_ruleCircuit {
+    enum { DEAD = 1, ALIVE = 2, ANY = DEAD | ALIVE };
+
+    int neighborhood;
+    int weights[8];
+    int sumBits;
+    int termCount;
+    struct {
+        int count;
+        int when;
+    } terms[32];
+};
+
+// Isotropic rule compiled for the bit-sliced CPU kernel: for every neighbor count and a dead and a live center, a
+// decision diagram over the eight neighbors that is true where the cell is alive next. A diagram only has to be right
+// for neighborhoods with its count, which keeps it small, the counts whose shapes are all included or all excluded
+// have constant diagrams and the diagrams share their nodes.
+const int ISOTROPIC_MAX_NODES = 18 * 255;  // 18 diagrams of at most 255 nodes
+
+struct st_isotropicTable {
+    // values are 0 for false, 1 for true and k + 2 for node k, which only refers to lower nodes
+    int roots[9][2];  // value of the diagram for a count and a dead (0) or live (1) center
+    int nodeCount;
+    struct {
+        int neighbor;  // bit of the 9-bit neighborhood as in st_rule
+        int low;  // value when the neighbor is dead
+        int high;  // and when it is alive
+    } nodes[ISOTROPIC_MAX_NODES];
+};
+
+// Larger than Life rule in Golly notation, e.g. "R5,C2,M1,S33..57,B34..45,NM" (Bosco's rule). The neighborhood is
+// the (2 * range + 1)^2 box, including the center cell when middle is set. States follow Generations rules.
+struct st_ltlRule {
+    int range;
+    int states;
+    int middle;
+    int surviveMin, surviveMax;
+    int birthMin, birthMax;
+};
+
+int parseRule(st_rule *rule, const char *rulestring);
+
+void formatRule(char *out, int size, const st_rule *rule);
+
+int parseLtlRule(st_ltlRule *rule, const char *rulestring);
+
+void formatLtlRule(char *out, int size, const st_ltlRule *rule);
+
+void compileRule(st_ruleCircuit *circuit, const st_rule *rule);
+
+void compileIsotropic(st_isotropicTable *table, const st_rule *rule);
+
+#endif
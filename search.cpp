@@ -0,0 +1,23 @@
+#include "soupSearch.h"
+
+#include <cstdint>
+
+// Soup search without a GPU: runs SOUPS random soups across every core and keeps CENSUS up to date while it runs.
+// Soups are numbered from 0 and reproducible from SEED, the census lists the first soup each object came from.
+
+const char *RULE = "B3/S23";
+const uint64_t SEED = 1;
+const long long SOUPS = 100000;
+const int THREADS = 0;  // every hardware thread
+const char *CENSUS = "census.txt";
+const double CENSUS_INTERVAL = 10;  // seconds between census writes
+
+int main() {
+    st_soupSearch search;
+    if (!createSoupSearch(&search, RULE, SEED)) {
+        return -1;
+    }
+    int success = runSoupSearch(&search, SOUPS, THREADS, CENSUS, CENSUS_INTERVAL);
+    destroySoupSearch(&search);
+    return success ? 0 : -1;
+}
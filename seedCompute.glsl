@@ -0,0 +1,83 @@
+#version 430 core
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) buffer Params {
+    int boardWidth;
+    int boardHeight;
+    int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
+};
+
+// cleared by the host, live cells are ORed in
+layout(std430, binding = 1) buffer CurrentBoard {
+    uint board[];
+};
+
+layout(location = 0) uniform uvec2 seed;  // low, high word of the 64-bit key
+layout(location = 1) uniform uint threshold;  // soupThreshold of the density
+
+const int SPAN = 64;  // cells per workgroup, one soupWord, a cell per invocation
+const int DENSITY_BITS = 16;
+
+// the Philox blocks of the soupWord of a row, drawn by the first invocations in parallel
+shared uvec4 sharedRandom[DENSITY_BITS / 2];
+
+// Philox4x32-10, same as philox4x32 in soup.cpp
+uvec4 philox(uvec4 counter, uvec2 key) {
+    for (int round = 0; round < 10; ++round) {
+        uint hi0, lo0, hi1, lo1;
+        umulExtended(0xD2511F53u, counter.x, hi0, lo0);
+        umulExtended(0xCD9E8D57u, counter.z, hi1, lo1);
+        counter = uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key += uvec2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return counter;
+}
+
+// soupWord as low and high half, from the blocks in sharedRandom
+uvec2 soupWord(int lowest) {
+    if (threshold == 0u || threshold >= (1u << DENSITY_BITS)) {
+        return threshold == 0u ? uvec2(0u) : uvec2(~0u);
+    }
+    uvec2 cells = uvec2(0u);
+    for (int bit = lowest, word = 0; bit < DENSITY_BITS; ++bit, ++word) {
+        uvec2 next = (word & 1) == 0 ? sharedRandom[word / 2].xy : sharedRandom[word / 2].zw;
+        cells = ((threshold >> bit) & 1u) != 0u ? cells | next : cells & next;
+    }
+    return cells;
+}
+
+void main() {
+    uint block = gl_WorkGroupID.x;
+    int lane = int(gl_LocalInvocationID.x);
+    int begin = int(block) * SPAN, end = min(begin + SPAN, boardWidth);
+    int lowest = findLSB(threshold);
+    bool drawn = threshold != 0u && threshold < (1u << DENSITY_BITS);
+
+    // there can be more rows than workgroups along y, each workgroup steps down by their count
+    for (int y = int(gl_WorkGroupID.y); y < boardHeight; y += int(gl_NumWorkGroups.y)) {
+        if (drawn && lane < (DENSITY_BITS - lowest + 1) / 2) {
+            sharedRandom[lane] = philox(uvec4(block, uint(y), uint(lane), 0u), seed);
+        }
+        barrier();
+        uvec2 cells = soupWord(lowest);
+        barrier();
+
+        // the invocation of the first cell of each board word gathers the word's cells of the span, the words at
+        // either end are shared with the neighboring blocks
+        int first = begin + lane + 1 + (y + 1) * boardStride;
+        if (begin + lane < end && (lane == 0 || (first & 3) == 0)) {
+            uint bits = 0u;
+            for (int index = first, i = lane; begin + i < end && (index == first || (index & 3) != 0); ++index, ++i) {
+                uint live = i < 32 ? (cells.x >> i) & 1u : (cells.y >> (i - 32)) & 1u;
+                bits |= live << ((index & 3) * 8);
+            }
+            if (bits != 0u) {
+                atomicOr(board[first >> 2], bits);
+            }
+        }
+    }
+}
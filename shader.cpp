@@ -0,0 +1,62 @@
+#include "shader.h"
+
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+#include <string>
+
+int createShader(unsigned int *shader, unsigned int type, const char *file, const char *defines) {
+    *shader = glCreateShader(type);
+
+    std::ifstream t(file);
+    std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+    if (defines) {
+        str.insert(str.find('\n') + 1, defines);
+    }
+    const char *c = str.c_str();
+
+    glShaderSource(*shader, 1, &c, nullptr);
+    glCompileShader(*shader);
+
+    int success;
+    glGetShaderiv(*shader, GL_COMPILE_STATUS, &success);
+
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(*shader, 512, nullptr, infoLog);
+        std::cout << "ERROR::SHADER::" << type << "::COMPILATION_FAILED" << std::endl;
+        std::cout << infoLog << std::endl;
+    }
+    return success;
+}
+
+int createAndLinkProgram(unsigned int *program, st_shaderInfo *shaders, int shaderCount) {
+    unsigned int shaderIds[shaderCount];
+    int success, shaderStatus = createShader(shaderIds, shaders[0].type, shaders[0].file, shaders[0].defines);
+    for (int i = 1; shaderStatus && i < shaderCount; ++i) {
+        shaderStatus = createShader(shaderIds + i, shaders[i].type, shaders[i].file, shaders[i].defines);
+    }
+
+    if (shaderStatus) {
+        *program = glCreateProgram();
+        for (int i = 0; i < shaderCount; ++i) {
+            glAttachShader(*program, shaderIds[i]);
+        }
+        glLinkProgram(*program);
+
+        glGetProgramiv(*program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(*program, 512, nullptr, infoLog);
+            std::cout << "ERROR::PROGRAM::LINKING_FAILED" << std::endl;
+            std::cout << infoLog << std::endl;
+        }
+    }
+
+    for (int i = 0; i < shaderCount; ++i) {
+        glDetachShader(*program, shaderIds[i]);
+        glDeleteShader(shaderIds[i]);
+    }
+
+    return shaderStatus && success;
+}
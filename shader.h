@@ -0,0 +1,16 @@
+#ifndef CONWAY_LIFE_SHADER_H
+#define CONWAY_LIFE_SHADER_H
+
+#include <glad/glad.h>
+
+struct st_shaderInfo {
+    unsigned int type;
+    const char *file;
+    const char *defines;  // inserted after the #version line, may be null
+};
+
+int createShader(unsigned int *shader, unsigned int type, const char *file, const char *defines);
+
+int createAndLinkProgram(unsigned int *program, st_shaderInfo *shaders, int shaderCount);
+
+#endif
@@ -0,0 +1,95 @@
+#include "soup.h"
+#include "parallel.h"
+
+#include <cstring>
+
+static inline void mulhilo(uint32_t a, uint32_t b, uint32_t *hi, uint32_t *lo) {
+    uint64_t product = (uint64_t) a * b;
+    *hi = (uint32_t) (product >> 32);
+    *lo = (uint32_t) product;
+}
+
+void philox4x32(uint32_t out[4], const uint32_t counter[4], uint64_t key) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = (uint32_t) key, k1 = (uint32_t) (key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(0xD2511F53u, c0, &hi0, &lo0);
+        mulhilo(0xCD9E8D57u, c2, &hi1, &lo1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+uint32_t soupThreshold(double density) {
+    double scaled = density * (1u << SOUP_DENSITY_BITS) + .5;
+    return scaled <= 0 ? 0 : scaled >= (1u << SOUP_DENSITY_BITS) ? 1u << SOUP_DENSITY_BITS : (uint32_t) scaled;
+}
+
+uint64_t soupWord(uint64_t seed, uint32_t threshold, uint32_t block, uint32_t y) {
+    if (threshold == 0 || threshold >= 1u << SOUP_DENSITY_BITS) {
+        return threshold ? ~0ull : 0;
+    }
+    int bit = 0;
+    while (!((threshold >> bit) & 1)) {
+        ++bit;
+    }
+    // every Philox call gives two words, word n comes from call n / 2
+    uint64_t cells = 0;
+    uint32_t random[4];
+    for (int word = 0; bit < SOUP_DENSITY_BITS; ++bit, ++word) {
+        if (!(word & 1)) {
+            const uint32_t counter[4] = {block, y, (uint32_t) word / 2, 0};
+            philox4x32(random, counter, seed);
+        }
+        uint64_t next = random[(word & 1) * 2] | (uint64_t) random[(word & 1) * 2 + 1] << 32;
+        cells = (threshold >> bit) & 1 ? cells | next : cells & next;
+    }
+    return cells;
+}
+
+void seedLifeBoard(st_lifeBoard *board, uint64_t seed, double density, int threads) {
+    const uint32_t threshold = soupThreshold(density);
+    const uint64_t lastMask = board->width & 63 ? (1ull << (board->width & 63)) - 1 : ~0ull;
+    // cleared band by band, not all from the calling thread, so that pages touched first here land on their band's node
+    const size_t rowBytes = (size_t) board->wordsPerRow * sizeof(uint64_t);
+    for (int p = 0; p < board->planes; ++p) {
+        memset(lifePlaneRow(board, p, -1), 0, rowBytes);
+        memset(lifePlaneRow(board, p, board->height), 0, rowBytes);
+    }
+    parallelFor(board->height, threads, [&](int begin, int end) {
+        for (int p = 1; p < board->planes; ++p) {
+            memset(lifePlaneRow(board, p, begin), 0, (end - begin) * rowBytes);
+        }
+        for (int y = begin; y < end; ++y) {
+            uint64_t *row = lifeRow(board, y);
+            for (int x = 0; x < board->wordsPerRow; ++x) {
+                row[x] = soupWord(seed, threshold, x, y);
+            }
+            row[board->wordsPerRow - 1] &= lastMask;
+        }
+    });
+}
+
+void seedCells(unsigned char *cells, int stride, int width, int height, uint64_t seed, double density, int threads) {
+    const uint32_t threshold = soupThreshold(density);
+    parallelFor(height, threads, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            unsigned char *row = cells + (size_t) y * stride;
+            for (int x = 0; x < width; x += 64) {
+                uint64_t word = soupWord(seed, threshold, x / 64, y);
+                for (int i = 0; i < 64 && x + i < width; ++i) {
+                    row[x + i] = (unsigned char) ((word >> i) & 1);
+                }
+            }
+        }
+    });
+}
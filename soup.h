@@ -0,0 +1,29 @@
+#ifndef CONWAY_LIFE_SOUP_H
+#define CONWAY_LIFE_SOUP_H
+
+#include "cpuLife.h"
+
+#include <cstdint>
+
+// Reproducible random soups from the counter-based Philox4x32-10 generator. Every block of 64 cells, x / 64 along
+// row y, is a pure function of the seed, so a board fills in any order, on any number of threads, and on the GPU
+// with the same result. The density is quantized to SOUP_DENSITY_BITS: a block folds one random 64-bit word per bit
+// of the threshold, from its lowest set bit up, OR for set bits and AND for clear ones, which leaves every cell alive
+// with probability threshold / 2^SOUP_DENSITY_BITS. One in two alive takes a single word.
+const int SOUP_DENSITY_BITS = 16;
+
+void philox4x32(uint32_t out[4], const uint32_t counter[4], uint64_t key);
+
+// Density in [0, 1] to a threshold in [0, 2^SOUP_DENSITY_BITS]
+uint32_t soupThreshold(double density);
+
+// Live cells of block (x / 64, y), bit i for cell x + i
+uint64_t soupWord(uint64_t seed, uint32_t threshold, uint32_t block, uint32_t y);
+
+// Fills the live plane of the board, clearing every other plane
+void seedLifeBoard(st_lifeBoard *board, uint64_t seed, double density, int threads);
+
+// One byte per cell, 0 or 1, cells pointing at cell (0, 0) with rows stride bytes apart
+void seedCells(unsigned char *cells, int stride, int width, int height, uint64_t seed, double density, int threads);
+
+#endif
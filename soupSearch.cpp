@@ -0,0 +1,579 @@
+#include "soupSearch.h"
+#include "cpuLife.h"
+#include "batchLife.h"
+#include "soup.h"
+#include "parallel.h"
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+static_assert(SEARCH_SIZE % 64 == 0, "SEARCH_SIZE must be a whole number of words");
+
+// scratch space of one worker
+struct st_searchWorker {
+    st_lifeBoard boards[2];
+    int top[2], bottom[2];  // rows [top, bottom) of each board may hold live cells
+    int current;
+    uint64_t edge;  // hashEdge when gliders were last looked for
+    uint64_t hashes[SEARCH_MAX_PERIOD];  // generation g at g % SEARCH_MAX_PERIOD
+    std::vector<uint64_t> phases;  // bit t set when the cell is alive t generations into the period
+    std::vector<int> stamps;  // cells visited by the current pass hold stamp
+    int stamp;
+    std::vector<int> stack;
+    st_lifeBoard alone[2];  // a candidate object run on its own, clear between uses
+    std::vector<int> owners;  // object + 1 of each cell of the cluster being split, 0 elsewhere
+};
+
+static inline int isAlive(const st_lifeBoard *board, int x, int y) {
+    return (int) (lifeRow(board, y)[x >> 6] >> (x & 63)) & 1;
+}
+
+static void clearRows(st_lifeBoard *board, int begin, int end) {
+    if (begin < end) {
+        memset(lifeRow(board, begin), 0, (size_t) (end - begin) * board->wordsPerRow * sizeof(uint64_t));
+    }
+}
+
+// Steps the live rows and the rows next to them, soups rarely cover more than a fraction of the board
+static void stepSearch(const st_soupSearch *search, st_searchWorker *worker) {
+    const int c = worker->current, n = 1 - c;
+    const st_lifeBoard *current = &worker->boards[c];
+    st_lifeBoard *next = &worker->boards[n];
+    int begin = std::max(worker->top[c] - 1, 0), end = std::min(worker->bottom[c] + 1, SEARCH_SIZE);
+    end = search->rule.isotropic ? stepIsotropicRange(next, current, search->table, begin, end)
+                                 : stepLifeRange(next, current, &search->circuit, begin, end);
+    // whatever the older board held outside the rows just written
+    clearRows(next, worker->top[n], std::min(begin, worker->bottom[n]));
+    clearRows(next, std::max(end, worker->top[n]), worker->bottom[n]);
+    worker->top[n] = begin;
+    worker->bottom[n] = end;
+    worker->current = n;
+}
+
+// Hash of the live cells, narrowing the live rows of the board down on the way
+static uint64_t hashBoard(st_searchWorker *worker) {
+    const st_lifeBoard *board = &worker->boards[worker->current];
+    int top = SEARCH_SIZE, bottom = 0;
+    uint64_t hash = 0;
+    for (int y = worker->top[worker->current]; y < worker->bottom[worker->current]; ++y) {
+        const uint64_t *row = lifeRow(board, y);
+        for (int x = 0; x < board->wordsPerRow; ++x) {
+            if (row[x]) {
+                hash = (hash ^ row[x] ^ (uint64_t) (x + y * board->wordsPerRow) << 48) * 0x9E3779B97F4A7C15ull;
+                hash ^= hash >> 31;
+                top = std::min(top, y);
+                bottom = y + 1;
+            }
+        }
+    }
+    worker->top[worker->current] = std::min(top, bottom);
+    worker->bottom[worker->current] = bottom;
+    return hash;
+}
+
+// Row y of soup n, bit x for cell x
+static uint64_t soupRow(const st_soupSearch *search, long long soup, int y) {
+    // soups past 2^32 continue in the rows below
+    return soupWord(search->seed, soupThreshold(.5), (uint32_t) soup, (uint32_t) ((soup >> 32) * SOUP_SIZE + y)) &
+           ((1ull << SOUP_SIZE) - 1);
+}
+
+static void seedSoup(const st_soupSearch *search, st_searchWorker *worker, long long soup) {
+    for (int b = 0; b < 2; ++b) {
+        clearRows(&worker->boards[b], worker->top[b], worker->bottom[b]);
+    }
+    st_lifeBoard *board = &worker->boards[0];
+    const int origin = (SEARCH_SIZE - SOUP_SIZE) / 2;
+    for (int y = 0; y < SOUP_SIZE; ++y) {
+        uint64_t cells = soupRow(search, soup, y);
+        for (int x = 0; x < SOUP_SIZE; ++x) {
+            if ((cells >> x) & 1) {
+                setCell(board, origin + x, origin + y, 1);
+            }
+        }
+    }
+    worker->current = 0;
+    worker->top[0] = origin;
+    worker->bottom[0] = origin + SOUP_SIZE;
+    worker->top[1] = worker->bottom[1] = 0;
+    worker->edge = 0;
+}
+
+// Collects the cluster around (x, y): every cell live(x, y) reachable in steps of at most two cells either way
+template<typename Live>
+static void collectObject(st_searchWorker *worker, int x, int y, const Live &live, std::vector<st_cell> *cells) {
+    cells->clear();
+    worker->stack.clear();
+    worker->stack.push_back(x + y * SEARCH_SIZE);
+    worker->stamps[x + y * SEARCH_SIZE] = worker->stamp;
+    while (!worker->stack.empty()) {
+        int index = worker->stack.back();
+        worker->stack.pop_back();
+        int cx = index % SEARCH_SIZE, cy = index / SEARCH_SIZE;
+        cells->push_back({cx, cy});
+        for (int ny = std::max(cy - 2, 0); ny <= std::min(cy + 2, SEARCH_SIZE - 1); ++ny) {
+            for (int nx = std::max(cx - 2, 0); nx <= std::min(cx + 2, SEARCH_SIZE - 1); ++nx) {
+                int neighbor = nx + ny * SEARCH_SIZE;
+                if (worker->stamps[neighbor] != worker->stamp && live(nx, ny)) {
+                    worker->stamps[neighbor] = worker->stamp;
+                    worker->stack.push_back(neighbor);
+                }
+            }
+        }
+    }
+}
+
+// Hash of the live cells within SEARCH_EDGE of the edge, 0 when there are none
+static uint64_t hashEdge(const st_searchWorker *worker) {
+    const st_lifeBoard *board = &worker->boards[worker->current];
+    const uint64_t left = (1ull << SEARCH_EDGE) - 1, right = ~0ull << (64 - SEARCH_EDGE);
+    uint64_t hash = 0;
+    for (int y = worker->top[worker->current]; y < worker->bottom[worker->current]; ++y) {
+        const uint64_t *row = lifeRow(board, y);
+        const bool band = y < SEARCH_EDGE || y >= board->height - SEARCH_EDGE;
+        for (int x = 0; x < board->wordsPerRow; ++x) {
+            uint64_t bits = band ? row[x] : row[x] & ((x == 0 ? left : 0) | (x == board->wordsPerRow - 1 ? right : 0));
+            if (bits) {
+                hash = (hash ^ bits ^ (uint64_t) (x + y * board->wordsPerRow) << 48) * 0x9E3779B97F4A7C15ull;
+                hash ^= hash >> 31;
+            }
+        }
+    }
+    return hash;
+}
+
+// Takes glider-shaped objects within SEARCH_EDGE of the edge off the board, returns whether there were any
+static bool removeGliders(const st_soupSearch *search, st_searchWorker *worker, long long soup, st_census *census) {
+    st_lifeBoard *board = &worker->boards[worker->current];
+    auto live = [board](int x, int y) {
+        return isAlive(board, x, y);
+    };
+    bool removed = false;
+    std::vector<st_cell> cells;
+    ++worker->stamp;
+    for (int y = worker->top[worker->current]; y < worker->bottom[worker->current]; ++y) {
+        const bool band = y < SEARCH_EDGE || y >= SEARCH_SIZE - SEARCH_EDGE;
+        for (int x = 0; x < SEARCH_SIZE; ++x) {
+            if (!band && x == SEARCH_EDGE) {
+                x = SEARCH_SIZE - SEARCH_EDGE;
+            }
+            if (worker->stamps[x + y * SEARCH_SIZE] == worker->stamp || !isAlive(board, x, y)) {
+                continue;
+            }
+            collectObject(worker, x, y, live, &cells);
+            if (cells.size() != 5) {
+                continue;
+            }
+            std::string code = wechslerCode({cells});
+            if (code == search->gliderShapes[0] || code == search->gliderShapes[1]) {
+                for (const st_cell &cell : cells) {
+                    setCell(board, cell.x, cell.y, 0);
+                }
+                censusAdd(census, search->glider, soup);
+                removed = true;
+            }
+        }
+    }
+    return removed;
+}
+
+// Whether cells, stepped on their own from their phase 0 on the board, go through exactly the phases they have there
+static bool evolvesAlone(const st_soupSearch *search, st_searchWorker *worker, const std::vector<st_cell> &cells,
+                         int period) {
+    const uint64_t *phases = worker->phases.data();
+    int top = SEARCH_SIZE, bottom = 0;
+    for (const st_cell &cell : cells) {
+        if (phases[cell.x + cell.y * SEARCH_SIZE] & 1) {
+            setCell(&worker->alone[0], cell.x, cell.y, 1);
+        }
+        top = std::min(top, cell.y);
+        bottom = std::max(bottom, cell.y + 1);
+    }
+    // a difference shows within a row of the object, so stepping two rows around it is enough until the first one
+    int begin = std::max(top - 2, 0) & ~1, end = std::min(bottom + 2, SEARCH_SIZE);
+    bool same = true;
+    for (int t = 1, c = 0; t <= period && same; ++t, c = 1 - c) {
+        const st_lifeBoard *current = &worker->alone[c];
+        st_lifeBoard *next = &worker->alone[1 - c];
+        end = search->rule.isotropic ? stepIsotropicRange(next, current, search->table, begin, end)
+                                     : stepLifeRange(next, current, &search->circuit, begin, end);
+        long long expected = 0, population = 0;
+        for (const st_cell &cell : cells) {
+            if ((phases[cell.x + cell.y * SEARCH_SIZE] >> (t % period)) & 1) {
+                ++expected;
+                same = same && isAlive(next, cell.x, cell.y);
+            }
+        }
+        for (int y = begin; y < end; ++y) {
+            for (int x = 0; x < next->wordsPerRow; ++x) {
+                population += __builtin_popcountll(lifeRow(next, y)[x]);
+            }
+        }
+        same = same && population == expected;
+    }
+    clearRows(&worker->alone[0], begin, end);
+    clearRows(&worker->alone[1], begin, end);
+    return same;
+}
+
+// Splits a cluster into the objects Catagolue counts. Cells connected at distance one start out as objects of their
+// own; one that does not go through its phases on its own, such as a quarter of a pulsar, takes in every object within
+// two cells of it until each of them does. Pseudo-objects such as a traffic light or a pair of blinkers come out as
+// their parts.
+static void splitCluster(const st_soupSearch *search, st_searchWorker *worker, const std::vector<st_cell> &cluster,
+                         int period, std::vector<std::vector<st_cell>> *objects) {
+    std::vector<int> &owners = worker->owners;
+    objects->clear();
+    for (const st_cell &cell : cluster) {
+        owners[cell.x + cell.y * SEARCH_SIZE] = -1;
+    }
+    for (const st_cell &start : cluster) {
+        if (owners[start.x + start.y * SEARCH_SIZE] != -1) {
+            continue;
+        }
+        const int owner = (int) objects->size() + 1;
+        objects->emplace_back(1, start);
+        std::vector<st_cell> &object = objects->back();
+        owners[start.x + start.y * SEARCH_SIZE] = owner;
+        for (size_t i = 0; i < object.size(); ++i) {
+            const st_cell cell = object[i];
+            for (int y = std::max(cell.y - 1, 0); y <= std::min(cell.y + 1, SEARCH_SIZE - 1); ++y) {
+                for (int x = std::max(cell.x - 1, 0); x <= std::min(cell.x + 1, SEARCH_SIZE - 1); ++x) {
+                    if (owners[x + y * SEARCH_SIZE] == -1) {
+                        owners[x + y * SEARCH_SIZE] = owner;
+                        object.push_back({x, y});
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < objects->size();) {
+        if ((*objects)[i].empty() || evolvesAlone(search, worker, (*objects)[i], period)) {
+            ++i;
+            continue;
+        }
+        // checked again with its neighbors in it
+        bool merged = false;
+        for (size_t c = 0, cells = (*objects)[i].size(); c < cells; ++c) {
+            const st_cell cell = (*objects)[i][c];
+            for (int y = std::max(cell.y - 2, 0); y <= std::min(cell.y + 2, SEARCH_SIZE - 1); ++y) {
+                for (int x = std::max(cell.x - 2, 0); x <= std::min(cell.x + 2, SEARCH_SIZE - 1); ++x) {
+                    int other = owners[x + y * SEARCH_SIZE] - 1;
+                    if (other >= 0 && other != (int) i) {
+                        for (const st_cell &moved : (*objects)[other]) {
+                            owners[moved.x + moved.y * SEARCH_SIZE] = (int) i + 1;
+                        }
+                        (*objects)[i].insert((*objects)[i].end(), (*objects)[other].begin(), (*objects)[other].end());
+                        (*objects)[other].clear();
+                        merged = true;
+                    }
+                }
+            }
+        }
+        i += merged ? 0 : 1;
+    }
+
+    for (const st_cell &cell : cluster) {
+        owners[cell.x + cell.y * SEARCH_SIZE] = 0;
+    }
+    objects->erase(std::remove_if(objects->begin(), objects->end(), [](const auto &object) {
+        return object.empty();
+    }), objects->end());
+}
+
+// Runs the settled board through one period and tallies every object with its own period
+static void tallyAsh(const st_soupSearch *search, st_searchWorker *worker, int period, long long soup,
+                     st_census *census) {
+    std::fill(worker->phases.begin(), worker->phases.end(), 0);
+    for (int t = 0; t < period; ++t) {
+        const st_lifeBoard *board = &worker->boards[worker->current];
+        for (int y = 0; y < SEARCH_SIZE; ++y) {
+            const uint64_t *row = lifeRow(board, y);
+            for (int x = 0; x < board->wordsPerRow; ++x) {
+                for (uint64_t bits = row[x]; bits; bits &= bits - 1) {
+                    worker->phases[64 * x + __builtin_ctzll(bits) + y * SEARCH_SIZE] |= 1ull << t;
+                }
+            }
+        }
+        stepSearch(search, worker);
+    }
+
+    const uint64_t *phases = worker->phases.data();
+    auto live = [phases](int x, int y) {
+        return phases[x + y * SEARCH_SIZE] != 0;
+    };
+    const uint64_t all = period == 64 ? ~0ull : (1ull << period) - 1;
+    std::vector<st_cell> cluster;
+    std::vector<std::vector<st_cell>> objects;
+    ++worker->stamp;
+    for (int i = 0; i < SEARCH_SIZE * SEARCH_SIZE; ++i) {
+        if (!phases[i] || worker->stamps[i] == worker->stamp) {
+            continue;
+        }
+        collectObject(worker, i % SEARCH_SIZE, i / SEARCH_SIZE, live, &cluster);
+        splitCluster(search, worker, cluster, period, &objects);
+
+        for (const std::vector<st_cell> &cells : objects) {
+            // smallest divisor of the board period that every cell of the object repeats with
+            int own = period;
+            for (int d = 1; d < period && own == period; ++d) {
+                bool repeats = period % d == 0;
+                for (size_t c = 0; repeats && c < cells.size(); ++c) {
+                    uint64_t mask = phases[cells[c].x + cells[c].y * SEARCH_SIZE];
+                    repeats = (((mask >> d) | (mask << (period - d))) & all) == mask;
+                }
+                own = repeats ? d : own;
+            }
+            std::vector<std::vector<st_cell>> shapes(own);
+            for (const st_cell &cell : cells) {
+                uint64_t mask = phases[cell.x + cell.y * SEARCH_SIZE];
+                for (int t = 0; t < own; ++t) {
+                    if ((mask >> t) & 1) {
+                        shapes[t].push_back(cell);
+                    }
+                }
+            }
+            std::string prefix = own == 1 ? "xs" + std::to_string(cells.size()) : "xp" + std::to_string(own);
+            censusAdd(census, prefix + "_" + wechslerCode(shapes), soup);
+        }
+    }
+}
+
+int createSoupSearch(st_soupSearch *search, const char *rule, uint64_t seed) {
+    *search = {};
+    if (!parseRule(&search->rule, rule)) {
+        return 0;
+    }
+    // B0 rules would fill the board from the empty rows that are never stepped
+    if (search->rule.states != 2 || search->rule.neighborhood != NEIGHBORHOOD_MOORE || (search->rule.birth & 1)) {
+        std::cout << "ERROR::SOUP_SEARCH::UNSUPPORTED_RULE" << std::endl;
+        return 0;
+    }
+    formatRule(search->ruleName, sizeof(search->ruleName), &search->rule);
+    compileRule(&search->circuit, &search->rule);
+    search->table = new st_isotropicTable;
+    compileIsotropic(search->table, &search->rule);
+    search->seed = seed;
+    search->batched = !search->rule.isotropic;
+
+    // the two shapes a glider takes, every other phase is one of them turned or mirrored
+    const std::vector<st_cell> shapes[2] = {{{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}},
+                                            {{0, 0}, {2, 0}, {1, 1}, {2, 1}, {1, 2}}};
+    search->gliderShapes[0] = wechslerCode({shapes[0]});
+    search->gliderShapes[1] = wechslerCode({shapes[1]});
+    search->glider = "xq4_" + wechslerCode({shapes[0], shapes[1]});
+    return 1;
+}
+
+void destroySoupSearch(st_soupSearch *search) {
+    delete search->table;
+    search->table = nullptr;
+}
+
+static int createWorker(st_searchWorker *worker) {
+    *worker = {};
+    int success = 1;
+    for (int b = 0; b < 2; ++b) {
+        success = createLifeBoard(&worker->boards[b], SEARCH_SIZE, SEARCH_SIZE, 2) && success;
+        success = createLifeBoard(&worker->alone[b], SEARCH_SIZE, SEARCH_SIZE, 2) && success;
+    }
+    worker->phases.resize(SEARCH_SIZE * SEARCH_SIZE);
+    worker->stamps.assign(SEARCH_SIZE * SEARCH_SIZE, 0);
+    worker->owners.assign(SEARCH_SIZE * SEARCH_SIZE, 0);
+    return success;
+}
+
+static void destroyWorker(st_searchWorker *worker) {
+    for (int b = 0; b < 2; ++b) {
+        destroyLifeBoard(&worker->boards[b]);
+        destroyLifeBoard(&worker->alone[b]);
+    }
+}
+
+// Runs the board in the worker, generation start of the soup, until it settles and tallies what it settles into
+static void settle(const st_soupSearch *search, st_searchWorker *worker, long long soup, int start,
+                   st_census *census) {
+    // the board is settled once it repeats, since every state determines all that follow
+    int period = 0;
+    for (int gen = start, since = start; gen < SEARCH_MAX_GENERATIONS && !period; ++gen) {
+        uint64_t hash = hashBoard(worker);
+        for (int p = 1; p <= std::min(gen - since, SEARCH_MAX_PERIOD) && !period; ++p) {
+            period = worker->hashes[(gen - p) % SEARCH_MAX_PERIOD] == hash ? p : 0;
+        }
+        worker->hashes[gen % SEARCH_MAX_PERIOD] = hash;
+        if (!period) {
+            // removing gliders changes the board, earlier generations no longer count
+            // debris stuck at the edge is only looked at again once it changes
+            uint64_t edge = gen % 4 == 0 ? hashEdge(worker) : 0;
+            if (edge && edge != worker->edge) {
+                worker->edge = edge;
+                if (removeGliders(search, worker, soup, census)) {
+                    since = gen + 1;
+                }
+            }
+            stepSearch(search, worker);
+        }
+    }
+    if (period) {
+        tallyAsh(search, worker, period, soup, census);
+    } else {
+        ++census->unsettled;
+    }
+    ++census->soups;
+}
+
+// Soups run 64 at a time on the batch engine, on a SEARCH_BATCH_SIZE square in the middle of the board, until they
+// settle, reach the edge of the square or run out of generations. Cells are only ever born next to live ones, so until
+// a soup touches the edge of the square its run there is the same as on the whole board: the ash of a settled soup is
+// tallied straight away, and only the soups that reach the edge carry on one at a time on the full board.
+static int searchBatched(const st_soupSearch *search, st_searchWorker *worker, long long first, long long count,
+                         st_census *census) {
+    st_lifeBatch batch;
+    if (!createLifeBatch(&batch, SEARCH_BATCH_SIZE, SEARCH_BATCH_SIZE, &search->rule, 1, SEARCH_MAX_PERIOD,
+                         SEARCH_MAX_GENERATIONS)) {
+        return 0;
+    }
+    const int origin = (SEARCH_BATCH_SIZE - SOUP_SIZE) / 2, offset = (SEARCH_SIZE - SEARCH_BATCH_SIZE) / 2;
+    long long next = first;
+    auto fill = [&](int lane) {
+        if (next == first + count) {
+            return false;
+        }
+        startBatchLane(&batch, lane, next);
+        for (int y = 0; y < SOUP_SIZE; ++y) {
+            for (uint64_t cells = soupRow(search, next, y); cells; cells &= cells - 1) {
+                setBatchCell(&batch, lane, origin + __builtin_ctzll(cells), origin + y, 1);
+            }
+        }
+        ++next;
+        return true;
+    };
+    auto finish = [&](int lane) {
+        // through the scratch board, then shifted into the middle of the board
+        const int c = worker->current;
+        st_lifeBoard *board = &worker->boards[c], *square = &worker->alone[0];
+        exportBatchLane(&batch, lane, square);
+        clearRows(board, worker->top[c], worker->bottom[c]);
+        for (int y = 0; y < SEARCH_BATCH_SIZE; ++y) {
+            uint64_t cells = lifeRow(square, y)[0], *row = lifeRow(board, y + offset) + (offset >> 6);
+            row[0] |= cells << (offset & 63);
+            if (offset & 63) {
+                row[1] |= cells >> (64 - (offset & 63));
+            }
+        }
+        clearRows(square, 0, SEARCH_BATCH_SIZE);
+        worker->top[c] = offset;
+        worker->bottom[c] = offset + SEARCH_BATCH_SIZE;
+        worker->edge = 0;
+        // settled soups are only run through their period, the others carry on from where they left the batch
+        const st_batchLane *state = &batch.lanes[lane];
+        if (state->period) {
+            tallyAsh(search, worker, state->period, state->id, census);
+            ++census->soups;
+        } else {
+            settle(search, worker, state->id, state->generation, census);
+        }
+        return true;
+    };
+    runLifeBatch(&batch, fill, finish);
+    destroyLifeBatch(&batch);
+    return 1;
+}
+
+void searchSoups(const st_soupSearch *search, long long first, long long count, st_census *census) {
+    st_searchWorker worker;
+    if (createWorker(&worker)) {
+        // one at a time when the batch could not be allocated either
+        if (!search->batched || !searchBatched(search, &worker, first, count, census)) {
+            for (long long soup = first; soup < first + count; ++soup) {
+                seedSoup(search, &worker, soup);
+                settle(search, &worker, soup, 0, census);
+            }
+        }
+    }
+    destroyWorker(&worker);
+}
+
+int searchPattern(const st_soupSearch *search, const std::vector<st_cell> &cells, st_census *census) {
+    st_searchWorker worker;
+    const int origin = SEARCH_SIZE / 2 - SOUP_SIZE;
+    int success = createWorker(&worker);
+    for (const st_cell &cell : cells) {
+        success = success && cell.x >= 0 && cell.y >= 0 && cell.x < 2 * SOUP_SIZE && cell.y < 2 * SOUP_SIZE;
+    }
+    if (success) {
+        for (const st_cell &cell : cells) {
+            setCell(&worker.boards[0], origin + cell.x, origin + cell.y, 1);
+        }
+        worker.top[0] = origin;
+        worker.bottom[0] = origin + 2 * SOUP_SIZE;
+        settle(search, &worker, 0, 0, census);
+    }
+    destroyWorker(&worker);
+    return success;
+}
+
+int runSoupSearch(const st_soupSearch *search, long long soups, int threads, const char *censusFile, double interval) {
+    if (threads <= 0) {
+        threads = hardwareThreads();
+    }
+    st_census total = {};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::atomic<long long> next(0);
+    int running = threads;
+
+    auto work = [&]() {
+        for (long long first; (first = next.fetch_add(SEARCH_CHUNK)) < soups;) {
+            st_census chunk = {};
+            searchSoups(search, first, std::min<long long>(SEARCH_CHUNK, soups - first), &chunk);
+            std::lock_guard<std::mutex> lock(mutex);
+            mergeCensus(&total, &chunk);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            finished.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(work);
+    }
+
+    // the census on disk is rewritten from a snapshot while the workers carry on
+    int success = 1;
+    auto begin = std::chrono::steady_clock::now();
+    auto deadline = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(interval));
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running > 0) {
+        if (finished.wait_until(lock, deadline) == std::cv_status::no_timeout) {
+            continue;
+        }
+        st_census snapshot = total;
+        lock.unlock();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Soups: " << snapshot.soups << ", " << snapshot.soups / seconds << " soups/s" << std::endl;
+        success = writeCensus(censusFile, &snapshot, search->ruleName, search->seed) && success;
+        deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(interval));
+        lock.lock();
+    }
+    lock.unlock();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Soups: " << total.soups << " in " << seconds << " s, " << total.soups / seconds << " soups/s, "
+              << total.objects.size() << " distinct objects, " << total.unsettled << " unsettled" << std::endl;
+    return writeCensus(censusFile, &total, search->ruleName, search->seed) && success;
+}
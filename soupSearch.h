@@ -0,0 +1,52 @@
+#ifndef CONWAY_LIFE_SOUP_SEARCH_H
+#define CONWAY_LIFE_SOUP_SEARCH_H
+
+#include "rule.h"
+#include "census.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Batch soup search in the manner of apgsearch. Soup n is a SOUP_SIZE square of Philox noise, one in two alive, in the
+// middle of a dead SEARCH_SIZE board; it runs on the bit-sliced CPU engine until the whole board repeats, checked
+// against a hash of each of the last SEARCH_MAX_PERIOD generations. Glider-shaped objects reaching the last
+// SEARCH_EDGE cells are taken off the board and counted before they hit the edge. The settled ash is split into
+// clusters of cells at most two apart in either direction, and clusters into the objects that go through their phases
+// on their own, so pseudo-objects are counted as their parts. Every object is named and tallied in the census.
+const int SOUP_SIZE = 16;
+const int SEARCH_SIZE = 128;  // multiple of 64
+const int SEARCH_EDGE = 8;
+const int SEARCH_MAX_PERIOD = 64;
+const int SEARCH_MAX_GENERATIONS = 20000;
+const int SEARCH_CHUNK = 256;  // soups a worker takes from the queue at a time
+const int SEARCH_BATCH_SIZE = 64;  // at most one word, soups run on a square this size in the middle of the board
+
+struct st_soupSearch {
+    st_rule rule;
+    st_ruleCircuit circuit;
+    st_isotropicTable *table;
+    char ruleName[128];
+    uint64_t seed;
+    bool batched;  // soups start 64 at a time on the batch engine, which has no isotropic rules
+    std::string glider;  // apgcode of the glider, and the code of each of its two shapes
+    std::string gliderShapes[2];
+};
+
+// Two-state rules on the Moore neighborhood, totalistic or isotropic
+int createSoupSearch(st_soupSearch *search, const char *rule, uint64_t seed);
+
+void destroySoupSearch(st_soupSearch *search);
+
+// Runs soups [first, first + count) on the calling thread and adds their objects to census
+void searchSoups(const st_soupSearch *search, long long first, long long count, st_census *census);
+
+// Runs cells, within 2 * SOUP_SIZE of (0, 0), in the middle of the board the same way as a soup and adds what they
+// settle into to census as soup 0. For checking the object names against known apgcodes.
+int searchPattern(const st_soupSearch *search, const std::vector<st_cell> &cells, st_census *census);
+
+// Runs soups [0, soups) on threads workers (<= 0 uses every hardware thread) pulling SEARCH_CHUNK soups at a time,
+// rewriting censusFile every interval seconds and once at the end
+int runSoupSearch(const st_soupSearch *search, long long soups, int threads, const char *censusFile, double interval);
+
+#endif
@@ -0,0 +1,79 @@
+#include "sparseLife.h"
+#include "rle.h"
+#include "soup.h"
+
+#include <cstdint>
+#include <iostream>
+#include <chrono>
+
+// Patterns that spread out over an unbounded plane, stepped on the CPU with memory following the live cells. PATTERN
+// is an RLE file, its rule replaces RULE; without one a SOUP_SIZE square soup is seeded from SEED.
+
+const char *PATTERN = nullptr;  // e.g. "breeder.rle"
+const char *RULE = "B3/S23";
+const int SOUP_SIZE = 256;
+const uint64_t SEED = 1;
+const double DENSITY = 0.5;
+const int GENERATIONS = 10000;
+const int REPORT_EVERY = 1000;
+const int THREADS = 0;  // every hardware thread
+
+// Reads the pattern or seeds the soup into a board and imports it with its top left corner at (0, 0)
+int loadPlane(st_sparseLife *life) {
+    st_lifeBoard board;
+    st_rule rule;
+    const char *ruleString = RULE;
+    st_rleReader reader;
+    if (PATTERN) {
+        if (!openRle(&reader, PATTERN)) {
+            return 0;
+        }
+        ruleString = reader.rule[0] ? reader.rule : RULE;
+    }
+    int success = parseRule(&rule, ruleString) && createSparseLife(life, &rule);
+    if (success && PATTERN) {
+        success = createLifeBoard(&board, reader.width, reader.height, 2);
+        if (success) {
+            success = readRleToBoard(&reader, &board, 0, 0) && importSparseLife(life, &board, 0, 0);
+            destroyLifeBoard(&board);
+        }
+    } else if (success) {
+        success = createLifeBoard(&board, SOUP_SIZE, SOUP_SIZE, 2);
+        if (success) {
+            seedLifeBoard(&board, SEED, DENSITY, THREADS);
+            success = importSparseLife(life, &board, 0, 0);
+            destroyLifeBoard(&board);
+        }
+    }
+    if (PATTERN) {
+        closeRle(&reader);
+    }
+    return success;
+}
+
+int main() {
+    st_sparseLife life;
+    if (!loadPlane(&life)) {
+        destroySparseLife(&life);
+        return -1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    while (life.generation < GENERATIONS) {
+        if (!stepSparseLife(&life, THREADS)) {
+            destroySparseLife(&life);
+            return -1;
+        }
+        if (life.generation % REPORT_EVERY == 0 || life.generation == GENERATIONS) {
+            long long bounds[4] = {};
+            sparseLifeBounds(&life, bounds);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::cout << "Generation " << life.generation << ", population " << sparseLifePopulation(&life)
+                      << ", bounds " << bounds[2] - bounds[0] << " x " << bounds[3] - bounds[1] << ", "
+                      << life.tiles.size() << " tiles, " << life.generation / seconds << " generations/s"
+                      << std::endl;
+        }
+    }
+    destroySparseLife(&life);
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "sparseLife.h"
+#include "parallel.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <bit>
+
+static inline uint64_t tileKey(long long tx, long long ty) {
+    return (uint64_t) (uint32_t) tx << 32 | (uint32_t) ty;
+}
+
+static inline long long tileX(uint64_t key) {
+    return (int32_t) (key >> 32);
+}
+
+static inline long long tileY(uint64_t key) {
+    return (int32_t) key;
+}
+
+static st_lifeTile *findTile(const st_sparseLife *life, long long tx, long long ty) {
+    auto it = life->tiles.find(tileKey(tx, ty));
+    return it == life->tiles.end() ? nullptr : it->second;
+}
+
+// nullptr when out of memory
+static st_lifeTile *addTile(st_sparseLife *life, long long tx, long long ty) {
+    auto [it, added] = life->tiles.try_emplace(tileKey(tx, ty), nullptr);
+    if (added) {
+        it->second = (st_lifeTile *) calloc(1, sizeof(st_lifeTile));
+        if (!it->second) {
+            std::cout << "ERROR::SPARSE_LIFE::ALLOCATION_FAILED" << std::endl;
+            life->tiles.erase(it);
+            return nullptr;
+        }
+    }
+    return it->second;
+}
+
+static bool emptyTile(const uint64_t *rows) {
+    uint64_t any = 0;
+    for (int y = 0; y < SPARSE_TILE; ++y) {
+        any |= rows[y];
+    }
+    return any == 0;
+}
+
+int createSparseLife(st_sparseLife *life, const st_rule *rule) {
+    life->tiles.clear();
+    life->current = 0;
+    life->generation = 0;
+    // birth on 0 neighbors would fill the whole plane
+    if (rule->states != 2 || rule->isotropic || (rule->birth & 1)) {
+        std::cout << "ERROR::SPARSE_LIFE::UNSUPPORTED_RULE" << std::endl;
+        return 0;
+    }
+    compileRule(&life->circuit, rule);
+    return 1;
+}
+
+void destroySparseLife(st_sparseLife *life) {
+    for (auto &[key, tile] : life->tiles) {
+        free(tile);
+    }
+    life->tiles.clear();
+}
+
+int setSparseCell(st_sparseLife *life, long long x, long long y, int alive) {
+    st_lifeTile *tile = alive ? addTile(life, x >> 6, y >> 6) : findTile(life, x >> 6, y >> 6);
+    if (tile) {
+        uint64_t *word = &tile->rows[life->current][y & 63];
+        *word = alive ? *word | 1ull << (x & 63) : *word & ~(1ull << (x & 63));
+    }
+    return tile || !alive;
+}
+
+int getSparseCell(const st_sparseLife *life, long long x, long long y) {
+    const st_lifeTile *tile = findTile(life, x >> 6, y >> 6);
+    return tile ? (int) (tile->rows[life->current][y & 63] >> (x & 63)) & 1 : 0;
+}
+
+int importSparseLife(st_sparseLife *life, const st_lifeBoard *board, long long x, long long y) {
+    for (int row = 0; row < board->height; ++row) {
+        const uint64_t *cells = lifeRow(board, row);
+        for (int word = 0; word < board->wordsPerRow; ++word) {
+            for (uint64_t bits = cells[word]; bits; bits &= bits - 1) {
+                if (!setSparseCell(life, x + 64 * word + std::countr_zero(bits), y + row, 1)) {
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+int stepSparseLife(st_sparseLife *life, int threads) {
+    const int current = life->current;
+
+    // every tile a live cell on a border could spill into must exist before the step
+    std::vector<uint64_t> spill;
+    for (auto &[key, tile] : life->tiles) {
+        const uint64_t *rows = tile->rows[current];
+        uint64_t columns = 0;
+        for (int y = 0; y < SPARSE_TILE; ++y) {
+            columns |= rows[y];
+        }
+        for (int dy = -1; dy <= 1; ++dy) {
+            // the cells facing the neighbors in this row of tiles, one bit per column
+            const uint64_t edge = dy < 0 ? rows[0] : dy > 0 ? rows[SPARSE_TILE - 1] : columns;
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx < 0 ? edge & 1 : dx > 0 ? edge >> 63 : dy && edge) {
+                    spill.push_back(tileKey(tileX(key) + dx, tileY(key) + dy));
+                }
+            }
+        }
+    }
+    for (uint64_t key : spill) {
+        if (!addTile(life, tileX(key), tileY(key))) {
+            return 0;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, st_lifeTile *>> tiles(life->tiles.begin(), life->tiles.end());
+    parallelFor((int) tiles.size(), threads, [&](int begin, int end) {
+        // the tile and its neighbors as three columns of words, the row above and below included
+        uint64_t columns[3][SPARSE_TILE + 2];
+        for (int i = begin; i < end; ++i) {
+            const long long tx = tileX(tiles[i].first), ty = tileY(tiles[i].first);
+            for (int dx = -1; dx <= 1; ++dx) {
+                uint64_t *column = columns[dx + 1];
+                const st_lifeTile *above = findTile(life, tx + dx, ty - 1);
+                const st_lifeTile *middle = dx ? findTile(life, tx + dx, ty) : tiles[i].second;
+                const st_lifeTile *below = findTile(life, tx + dx, ty + 1);
+                column[0] = above ? above->rows[current][SPARSE_TILE - 1] : 0;
+                for (int y = 0; y < SPARSE_TILE; ++y) {
+                    column[y + 1] = middle ? middle->rows[current][y] : 0;
+                }
+                column[SPARSE_TILE + 1] = below ? below->rows[current][0] : 0;
+            }
+            stepLifeColumn(tiles[i].second->rows[current ^ 1], columns[0], columns[1], columns[2], SPARSE_TILE,
+                           &life->circuit);
+        }
+    });
+
+    life->current ^= 1;
+    ++life->generation;
+    for (auto it = life->tiles.begin(); it != life->tiles.end();) {
+        if (emptyTile(it->second->rows[life->current])) {
+            free(it->second);
+            it = life->tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return 1;
+}
+
+long long sparseLifePopulation(const st_sparseLife *life) {
+    long long population = 0;
+    for (auto &[key, tile] : life->tiles) {
+        for (int y = 0; y < SPARSE_TILE; ++y) {
+            population += std::popcount(tile->rows[life->current][y]);
+        }
+    }
+    return population;
+}
+
+int sparseLifeBounds(const st_sparseLife *life, long long bounds[4]) {
+    bool found = false;
+    for (auto &[key, tile] : life->tiles) {
+        const uint64_t *rows = tile->rows[life->current];
+        const long long x = tileX(key) * SPARSE_TILE, y = tileY(key) * SPARSE_TILE;
+        for (int row = 0; row < SPARSE_TILE; ++row) {
+            if (!rows[row]) {
+                continue;
+            }
+            const long long left = x + std::countr_zero(rows[row]), right = x + 64 - std::countl_zero(rows[row]);
+            bounds[0] = found ? std::min(bounds[0], left) : left;
+            bounds[1] = found ? std::min(bounds[1], y + row) : y + row;
+            bounds[2] = found ? std::max(bounds[2], right) : right;
+            bounds[3] = found ? std::max(bounds[3], y + row + 1) : y + row + 1;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,48 @@
+#ifndef CONWAY_LIFE_SPARSE_LIFE_H
+#define CONWAY_LIFE_SPARSE_LIFE_H
+
+#include "rule.h"
+#include "cpuLife.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+// Unbounded plane of SPARSE_TILE x SPARSE_TILE tiles, bit-packed one word per row, kept in a hash map by tile
+// coordinates. Cells outside every tile are dead. Before each step a tile is added next to every border holding live
+// cells, and tiles left empty by the step are freed, so memory follows the live area rather than its bounding box.
+const int SPARSE_TILE = 64;
+
+struct st_lifeTile {
+    uint64_t rows[2][SPARSE_TILE];  // the generation in current and the one being written
+};
+
+struct st_sparseLife {
+    st_ruleCircuit circuit;
+    std::unordered_map<uint64_t, st_lifeTile *> tiles;
+    int current;
+    long long generation;
+};
+
+// Two-state rules without isotropic conditions or birth on 0 neighbors, on any neighborhood
+int createSparseLife(st_sparseLife *life, const st_rule *rule);
+
+void destroySparseLife(st_sparseLife *life);
+
+// Cell coordinates may be negative, tile coordinates are 32-bit. Returns 0 when out of memory, as do the functions
+// below that add tiles.
+int setSparseCell(st_sparseLife *life, long long x, long long y, int alive);
+
+int getSparseCell(const st_sparseLife *life, long long x, long long y);
+
+// Sets the live cells of board with its top left corner at (x, y)
+int importSparseLife(st_sparseLife *life, const st_lifeBoard *board, long long x, long long y);
+
+// Advances the plane by one generation, threads as for parallelFor
+int stepSparseLife(st_sparseLife *life, int threads);
+
+long long sparseLifePopulation(const st_sparseLife *life);
+
+// Bounding box [bounds[0], bounds[2]) x [bounds[1], bounds[3]) of the live cells. Returns 0 when there are none.
+int sparseLifeBounds(const st_sparseLife *life, long long bounds[4]);
+
+#endif
@@ -0,0 +1,82 @@
+#include "sparseLife.h"
+#include "cpuLife.h"
+#include "soup.h"
+#include "testReport.h"
+
+#include <iostream>
+#include <utility>
+
+// Steps a soup on the sparse plane, placed at negative coordinates, next to the same soup in the middle of a board
+// large enough that nothing reaches its edge, and compares them. Then sends a glider far off and checks that it
+// arrives whole and that the plane only holds the tiles around it. The exit code tells whether everything matched.
+
+const int BOARD_SIZE = 512;
+const int SOUP = 80;
+const int GENERATIONS = 150;
+const int GLIDER_GENERATIONS = 40000;
+
+// mismatched cells over the whole board
+static long long crossCheck(const char *ruleString) {
+    st_rule rule;
+    st_ruleCircuit circuit;
+    st_sparseLife life;
+    if (!parseRule(&rule, ruleString) || !createSparseLife(&life, &rule)) {
+        return -1;
+    }
+    compileRule(&circuit, &rule);
+    st_lifeBoard boards[2], soup;
+    createLifeBoard(&boards[0], BOARD_SIZE, BOARD_SIZE, 2);
+    createLifeBoard(&boards[1], BOARD_SIZE, BOARD_SIZE, 2);
+    createLifeBoard(&soup, SOUP, SOUP, 2);
+    seedLifeBoard(&soup, 7, .4, 1);
+    const int origin = (BOARD_SIZE - SOUP) / 2;
+    const long long left = -100, top = -37;
+    for (int y = 0; y < SOUP; ++y) {
+        for (int x = 0; x < SOUP; ++x) {
+            setCell(&boards[0], origin + x, origin + y, getCell(&soup, x, y));
+        }
+    }
+    long long mismatches = importSparseLife(&life, &soup, left, top) ? 0 : -1;
+    for (int generation = 0; generation < GENERATIONS && mismatches == 0; ++generation) {
+        stepLife(&boards[1], &boards[0], &circuit, 1, nullptr);
+        std::swap(boards[0], boards[1]);
+        mismatches = stepSparseLife(&life, 2) ? 0 : -1;
+    }
+    for (int y = 0; y < BOARD_SIZE && mismatches >= 0; ++y) {
+        for (int x = 0; x < BOARD_SIZE; ++x) {
+            mismatches += getCell(&boards[0], x, y) != getSparseCell(&life, left - origin + x, top - origin + y);
+        }
+    }
+    destroyLifeBoard(&soup);
+    destroyLifeBoard(&boards[0]);
+    destroyLifeBoard(&boards[1]);
+    destroySparseLife(&life);
+    return mismatches;
+}
+
+int main() {
+    int failures = crossCheckRules(crossCheck);
+
+    // a glider moves one cell diagonally every 4 generations, here up and to the left
+    st_rule rule;
+    st_sparseLife life;
+    parseRule(&rule, "B3/S23");
+    createSparseLife(&life, &rule);
+    for (const auto &[x, y] : {std::pair{0, 0}, {1, 0}, {2, 0}, {0, 1}, {1, 2}}) {
+        setSparseCell(&life, x, y, 1);
+    }
+    for (int generation = 0; generation < GLIDER_GENERATIONS; ++generation) {
+        stepSparseLife(&life, 1);
+    }
+    const long long distance = GLIDER_GENERATIONS / 4;
+    long long bounds[4] = {};
+    const bool arrived = sparseLifeBounds(&life, bounds) && sparseLifePopulation(&life) == 5 &&
+                         bounds[0] == -distance && bounds[1] == -distance && bounds[2] == 3 - distance &&
+                         bounds[3] == 3 - distance && life.tiles.size() <= 4;
+    std::cout << "Glider after " << GLIDER_GENERATIONS << " generations: " << (arrived ? "arrived" : "lost") << ", "
+              << life.tiles.size() << " tiles" << std::endl;
+    failures += !arrived;
+    destroySparseLife(&life);
+
+    return reportTest("Sparse", failures);
+}
@@ -0,0 +1,93 @@
+#version 430 core
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// Side outputs of the life kernels, linked into each of them. Every invocation adds the words it writes with
+// statsWord, then the workgroup reduces them in shared memory and one invocation adds the totals to the slot of the
+// generation, so the board is never read twice.
+
+// partial sums of the board hash of the last CONWAY_HASH_RING generations, see conwayPeriod
+layout(std430, binding = 4) buffer Hashes {
+    uvec2 hashes[];
+};
+
+// population, births, deaths, ~left, ~top, right + 1, bottom + 1 and a spare word per generation, 0 before any cell
+layout(std430, binding = 5) buffer Stats {
+    uint stats[];
+};
+
+layout(location = 0) uniform int statsSlot;  // generation % CONWAY_HASH_RING of the board being written
+
+const int HASH_PARTS = 64;
+const int STATS_WORDS = 8;
+
+uvec3 counts = uvec3(0u);  // population, births, deaths of this invocation
+uvec2 hash = uvec2(0u);
+uvec4 extent = uvec4(0u);  // the bounds as stored in stats, reduced by max
+
+shared uvec3 sharedCounts[64];
+shared uvec2 sharedHash[64];
+shared uvec4 sharedExtent[64];
+
+uint mixBits(uint x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// cells and old are the new and previous states of board word `word`, cells x .. x + 3 of row y, with bytes outside
+// the board cleared. The hash is a sum over the nonzero words, so it comes out the same in any order.
+void statsWord(int word, int x, int y, uint cells, uint old) {
+    if (cells != 0u) {
+        uint key = mixBits(uint(word));
+        hash += uvec2(mixBits(cells ^ key), mixBits(cells + mixBits(key ^ 0x9E3779B9u)));
+    }
+    for (int b = 0; b < 4; ++b) {
+        uint state = (cells >> (b * 8)) & 0xFFu, before = (old >> (b * 8)) & 0xFFu;
+        if (state == 1u) {
+            counts.x += 1u;
+            extent = max(extent, uvec4(~uint(x + b), ~uint(y), uint(x + b + 1), uint(y + 1)));
+        }
+        counts.y += state == 1u && before == 0u ? 1u : 0u;
+        counts.z += state != 1u && before == 1u ? 1u : 0u;
+    }
+}
+
+// Called once by every invocation of the workgroup, after its last statsWord
+void statsFlush() {
+    uint i = gl_LocalInvocationIndex;
+    sharedCounts[i] = counts;
+    sharedHash[i] = hash;
+    sharedExtent[i] = extent;
+    barrier();
+    for (uint span = gl_WorkGroupSize.x / 2u; span > 0u; span /= 2u) {
+        if (i < span) {
+            sharedCounts[i] += sharedCounts[i + span];
+            sharedHash[i] += sharedHash[i + span];
+            sharedExtent[i] = max(sharedExtent[i], sharedExtent[i + span]);
+        }
+        barrier();
+    }
+    if (i == 0u) {
+        uint group = gl_WorkGroupID.x + gl_WorkGroupID.y * gl_NumWorkGroups.x;
+        int part = statsSlot * HASH_PARTS + int(group % uint(HASH_PARTS));
+        if (sharedHash[0] != uvec2(0u)) {
+            atomicAdd(hashes[part].x, sharedHash[0].x);
+            atomicAdd(hashes[part].y, sharedHash[0].y);
+        }
+        int base = statsSlot * STATS_WORDS;
+        if (sharedCounts[0] != uvec3(0u)) {
+            atomicAdd(stats[base], sharedCounts[0].x);
+            atomicAdd(stats[base + 1], sharedCounts[0].y);
+            atomicAdd(stats[base + 2], sharedCounts[0].z);
+        }
+        if (sharedExtent[0].z != 0u) {
+            atomicMax(stats[base + 3], sharedExtent[0].x);
+            atomicMax(stats[base + 4], sharedExtent[0].y);
+            atomicMax(stats[base + 5], sharedExtent[0].z);
+            atomicMax(stats[base + 6], sharedExtent[0].w);
+        }
+    }
+}
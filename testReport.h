@@ -0,0 +1,31 @@
+#ifndef CONWAY_LIFE_TEST_REPORT_H
+#define CONWAY_LIFE_TEST_REPORT_H
+
+#include <iostream>
+
+// What the ctest self-checks share: the rules engines are checked against the single-board engine on and the way the
+// results are printed.
+
+// Moore, hexagonal, von Neumann and weighted neighborhoods
+const char *const CROSS_CHECK_RULES[] = {"B3/S23", "B36/S23", "B2/S34H", "B2/S013V", "B3,5/S2,3,4/W21212121"};
+
+// Prints crossCheck(rule), the mismatched cells or -1 when the engine could not be set up, for each of
+// CROSS_CHECK_RULES and returns how many did not match
+template<typename CrossCheck>
+int crossCheckRules(const CrossCheck &crossCheck) {
+    int failures = 0;
+    for (const char *rule : CROSS_CHECK_RULES) {
+        const long long mismatches = crossCheck(rule);
+        std::cout << rule << ": " << mismatches << " mismatched cells" << std::endl;
+        failures += mismatches != 0;
+    }
+    return failures;
+}
+
+// Prints whether the test passed and returns its exit code
+inline int reportTest(const char *name, int failures) {
+    std::cout << name << " test: " << (failures ? "failed" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -1,20 +1,30 @@
 #version 430 core
 layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
 layout(rgba32f, binding = 0) uniform image2D img;
+layout(location = 0) uniform int generations;  // since the texture was last drawn
 
 layout(std430, binding = 0) buffer Params {
     int boardWidth;
     int boardHeight;
     int neighborIndices[8];
+    int birth;
+    int survive;
+    int states;
+    int boardStride;
 };
 
 layout(std430, binding = 1) buffer Board {
-    float board[];
+    uint board[];
 };
 
 void main() {
     uint x = gl_WorkGroupID.x;
     uint y = gl_WorkGroupID.y;
-    float boardVal = board[x + 1 + (y + 1) * (boardWidth + 2)];
+    uint index = x + 1 + (y + 1) * uint(boardStride);
+    uint state = (board[index >> 2] >> ((index & 3u) * 8u)) & 0xFFu;
+    // live cells are full brightness, decaying cells fade by half per generation. Two-state rules have no decay
+    // states, their dead cells fade the same way from what the texture last showed.
+    float boardVal = state != 0u ? exp2(1.0 - float(state))
+                   : states == 2 ? imageLoad(img, ivec2(gl_GlobalInvocationID.xy)).b * exp2(-float(generations)) : 0.0;
     imageStore(img, ivec2(gl_GlobalInvocationID.xy), vec4(0.0, 0.0, boardVal, 1.0));
 }